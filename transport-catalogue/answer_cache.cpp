@@ -0,0 +1,108 @@
+#include "answer_cache.h"
+
+namespace json {
+
+	std::string_view AnswerFragment::Prefix() const {
+		return std::string_view(text).substr(0, id_position);
+	}
+
+	std::string_view AnswerFragment::Suffix() const {
+		return std::string_view(text).substr(id_position + id_length);
+	}
+
+	AnswerCache::AnswerCache(size_t capacity) : capacity_(capacity) {
+	}
+
+	const AnswerFragment* AnswerCache::Find(std::string_view type, std::string_view name) {
+		const auto it = index_.find(EntryKey{ type, name });
+		if (it == index_.end()) {
+			++stats_.misses;
+			return nullptr;
+		};
+		++stats_.hits;
+		//moving entry to front without reallocation, iterators stay valid
+		entries_.splice(entries_.begin(), entries_, it->second);
+		return &it->second->fragment;
+	}
+
+	void AnswerCache::Insert(std::string_view type, std::string_view name, AnswerFragment fragment) {
+		if (capacity_ == 0) {
+			return;
+		};
+		const auto it = index_.find(EntryKey{ type, name });
+		if (it != index_.end()) {
+			it->second->fragment = std::move(fragment);
+			entries_.splice(entries_.begin(), entries_, it->second);
+			return;
+		};
+
+		entries_.push_front(Entry{ std::string(type), std::string(name), std::move(fragment) });
+		const Entry& entry = entries_.front();
+		index_.emplace(EntryKey{ entry.type, entry.name }, entries_.begin());
+		Shrink();
+	}
+
+	void AnswerCache::SetCapacity(size_t capacity) {
+		capacity_ = capacity;
+		Shrink();
+	}
+
+	void AnswerCache::Clear() {
+		index_.clear();
+		entries_.clear();
+	}
+
+	const AnswerCache::Stats& AnswerCache::GetStats() const {
+		return stats_;
+	}
+
+	void AnswerCache::Shrink() {
+		while (entries_.size() > capacity_) {
+			const Entry& entry = entries_.back();
+			index_.erase(EntryKey{ entry.type, entry.name });
+			entries_.pop_back();
+			++stats_.evictions;
+		};
+	}
+
+	SharedAnswerCache::SharedAnswerCache(size_t capacity) {
+		SetCapacity(capacity);
+	}
+
+	void SharedAnswerCache::Insert(std::string_view type, std::string_view name, AnswerFragment fragment) {
+		Shard& shard = GetShard(name);
+		std::lock_guard lock(shard.mutex);
+		shard.cache.Insert(type, name, std::move(fragment));
+	}
+
+	void SharedAnswerCache::SetCapacity(size_t capacity) {
+		for (Shard& shard : shards_) {
+			std::lock_guard lock(shard.mutex);
+			shard.cache.SetCapacity((capacity + SHARDS_COUNT - 1) / SHARDS_COUNT);
+		};
+	}
+
+	void SharedAnswerCache::Clear() {
+		for (Shard& shard : shards_) {
+			std::lock_guard lock(shard.mutex);
+			shard.cache.Clear();
+		};
+	}
+
+	AnswerCache::Stats SharedAnswerCache::GetStats() const {
+		AnswerCache::Stats stats;
+		for (const Shard& shard : shards_) {
+			std::lock_guard lock(shard.mutex);
+			const AnswerCache::Stats& shard_stats = shard.cache.GetStats();
+			stats.hits += shard_stats.hits;
+			stats.misses += shard_stats.misses;
+			stats.evictions += shard_stats.evictions;
+		};
+		return stats;
+	}
+
+	SharedAnswerCache::Shard& SharedAnswerCache::GetShard(std::string_view name) {
+		return shards_[std::hash<std::string_view>{}(name) % SHARDS_COUNT];
+	}
+
+}//end of namespace json
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace json {
+
+	//serialized answer without request id, id is written at id_position on printing
+	struct AnswerFragment {
+		std::string text;
+		size_t id_position{};
+		size_t id_length{}; //length of placeholder id in text
+
+		std::string_view Prefix() const;
+
+		std::string_view Suffix() const;
+	};
+
+	//bounded LRU cache of serialized answers keyed by requested object type and name,
+	//answers for the same object differ only by request id
+	class AnswerCache {
+	public:
+		explicit AnswerCache(size_t capacity = DEFAULT_CAPACITY);
+
+		static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+		//returns nullptr on miss, pointer is valid until next Insert
+		const AnswerFragment* Find(std::string_view type, std::string_view name);
+
+		//oldest used entry is dropped when cache is full, nothing is stored if capacity is 0
+		void Insert(std::string_view type, std::string_view name, AnswerFragment fragment);
+
+		void SetCapacity(size_t capacity);
+
+		void Clear();
+
+		struct Stats {
+			uint64_t hits{};
+			uint64_t misses{};
+			uint64_t evictions{};
+		};
+
+		const Stats& GetStats() const;
+
+	private:
+		struct Entry {
+			std::string type;
+			std::string name;
+			AnswerFragment fragment;
+		};
+
+		//views to strings stored in entry
+		struct EntryKey {
+			std::string_view type;
+			std::string_view name;
+
+			bool operator==(const EntryKey& other) const {
+				return type == other.type && name == other.name;
+			}
+		};
+
+		struct EntryKeyHasher {
+			size_t operator()(const EntryKey& key) const {
+				return std::hash<std::string_view>{}(key.name) * 37 + std::hash<std::string_view>{}(key.type);
+			}
+		};
+
+		size_t capacity_;
+		//most recently used entries are in front
+		std::list<Entry> entries_{};
+		std::unordered_map<EntryKey, std::list<Entry>::iterator, EntryKeyHasher> index_{};
+		Stats stats_{};
+
+		void Shrink();
+	};
+
+	//answer cache used by several threads at once. entries are spread among shards by names and every shard
+	//has its own lock, so threads answering about different objects do not wait for each other
+	class SharedAnswerCache {
+	public:
+		explicit SharedAnswerCache(size_t capacity = AnswerCache::DEFAULT_CAPACITY);
+
+		static constexpr size_t SHARDS_COUNT = 16;
+
+		//found fragment is passed to action while its shard is locked, returns false on miss
+		template <typename Action>
+		bool Find(std::string_view type, std::string_view name, Action action);
+
+		void Insert(std::string_view type, std::string_view name, AnswerFragment fragment);
+
+		//capacity is divided among shards
+		void SetCapacity(size_t capacity);
+
+		void Clear();
+
+		//sum of stats of all shards
+		AnswerCache::Stats GetStats() const;
+
+	private:
+		struct Shard {
+			mutable std::mutex mutex;
+			AnswerCache cache;
+		};
+
+		std::array<Shard, SHARDS_COUNT> shards_;
+
+		Shard& GetShard(std::string_view name);
+	};
+
+	template <typename Action>
+	bool SharedAnswerCache::Find(std::string_view type, std::string_view name, Action action) {
+		Shard& shard = GetShard(name);
+		std::lock_guard lock(shard.mutex);
+		const AnswerFragment* fragment = shard.cache.Find(type, name);
+		if (!fragment) {
+			return false;
+		};
+		action(*fragment);
+		return true;
+	}
+
+}//end of namespace json
\ No newline at end of file
@@ -0,0 +1,811 @@
+#include <algorithm>
+#include <chrono>
+#include <charconv>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../json.h"
+#include "../json_index.h"
+#include "../json_reader.h"
+#include "../map_renderer.h"
+#include "../request_handler.h"
+#include "../transport_catalogue.h"
+#include "legacy.h"
+#include "legacy_json.h"
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+
+//generates feed of given size and measures processing stages of current version against versions
+//which were replaced by backlog requests, request of every stage is given in brackets
+namespace {
+	struct FeedOptions {
+		size_t stops = 20000;
+		size_t buses = 2000;
+		size_t requests = 20000;
+		size_t seed = 1;
+	};
+
+	struct StopData {
+		std::string name;
+		geo::Coordinates coordinates;
+		std::vector<std::pair<size_t, int>> distances; //to stops with given indexes
+	};
+
+	struct BusData {
+		std::string name;
+		bool is_roundtrip{};
+		std::vector<size_t> stops; //indexes of stops, roundtrip route ends with its first stop
+	};
+
+	//names of some requests are not in feed
+	struct RequestData {
+		std::string type;
+		std::string name;
+	};
+
+	struct Feed {
+		std::vector<StopData> stops;
+		std::vector<BusData> buses;
+		std::vector<RequestData> requests;
+	};
+
+	std::string StopName(size_t i) {
+		return "Stop "s + std::to_string(i);
+	}
+
+	//stops have up to 3 random road distances, most segments of routes have road distance too.
+	//half of buses are roundtrip, first request is for map, others are for buses and stops
+	Feed GenerateFeed(const FeedOptions& options) {
+		std::mt19937_64 random(options.seed);
+		const auto uniform = [&random](size_t from, size_t to) {
+			return std::uniform_int_distribution<size_t>(from, to)(random);
+		};
+		const auto chance = [&random](double probability) {
+			return std::uniform_real_distribution<double>(0.0, 1.0)(random) < probability;
+		};
+		//baseline parser breaks keys which are given twice, so distance to same stop is replaced
+		const auto set_distance = [](StopData& stop, size_t to, int length) {
+			const auto found = std::find_if(stop.distances.begin(), stop.distances.end(), [to](const auto& distance) {
+				return distance.first == to;
+			});
+			if (found == stop.distances.end()) {
+				stop.distances.emplace_back(to, length);
+			}
+			else {
+				found->second = length;
+			};
+		};
+
+		Feed feed;
+		for (size_t i = 0; i < options.stops; ++i) {
+			StopData& stop = feed.stops.emplace_back();
+			stop.name = StopName(i);
+			stop.coordinates = { 43.5 + std::uniform_real_distribution<double>(0.0, 0.2)(random),
+				39.7 + std::uniform_real_distribution<double>(0.0, 0.2)(random) };
+			for (size_t j = uniform(0, 3); j > 0; --j) {
+				const size_t to = uniform(0, options.stops - 1);
+				set_distance(stop, to, static_cast<int>(uniform(100, 5000)));
+			};
+		};
+		for (size_t i = 0; i < options.buses; ++i) {
+			BusData& bus = feed.buses.emplace_back();
+			bus.name = "Bus "s + std::to_string(i);
+			bus.is_roundtrip = chance(0.5);
+			for (size_t j = uniform(2, 12); j > 0; --j) {
+				bus.stops.push_back(uniform(0, options.stops - 1));
+			};
+			if (bus.is_roundtrip) {
+				bus.stops.push_back(bus.stops.front());
+			};
+			for (size_t j = 0; j + 1 < bus.stops.size(); ++j) {
+				if (chance(0.7)) {
+					set_distance(feed.stops[bus.stops[j]], bus.stops[j + 1], static_cast<int>(uniform(100, 5000)));
+				};
+			};
+		};
+		for (size_t i = 0; i < options.requests; ++i) {
+			if (i == 0) {
+				feed.requests.push_back({ "Map"s, ""s });
+			}
+			else if (chance(0.5)) {
+				feed.requests.push_back({ "Bus"s, "Bus "s + std::to_string(uniform(0, options.buses + options.buses / 100)) });
+			}
+			else {
+				feed.requests.push_back({ "Stop"s, StopName(uniform(0, options.stops + options.stops / 100)) });
+			};
+		};
+		return feed;
+	}
+
+	std::string PrintFeed(const Feed& feed) {
+		std::ostringstream out;
+		out.precision(17);
+		out << "{\"base_requests\": [\n";
+		for (const StopData& stop : feed.stops) {
+			out << "{\"type\": \"Stop\", \"name\": \"" << stop.name << "\", \"latitude\": " << stop.coordinates.lat
+				<< ", \"longitude\": " << stop.coordinates.lng << ", \"road_distances\": {";
+			for (size_t i = 0; i < stop.distances.size(); ++i) {
+				out << (i == 0 ? "" : ", ") << '"' << feed.stops[stop.distances[i].first].name << "\": " << stop.distances[i].second;
+			};
+			out << "}},\n";
+		};
+		for (size_t i = 0; i < feed.buses.size(); ++i) {
+			const BusData& bus = feed.buses[i];
+			out << "{\"type\": \"Bus\", \"name\": \"" << bus.name << "\", \"is_roundtrip\": " << (bus.is_roundtrip ? "true" : "false")
+				<< ", \"stops\": [";
+			for (size_t j = 0; j < bus.stops.size(); ++j) {
+				out << (j == 0 ? "" : ", ") << '"' << feed.stops[bus.stops[j]].name << '"';
+			};
+			out << "]}" << (i + 1 == feed.buses.size() ? "\n" : ",\n");
+		};
+		out << "],\n\"render_settings\": {\"width\": 1200.0, \"height\": 1200.0, \"padding\": 50.0, \"stop_radius\": 5,"
+			<< " \"line_width\": 14.0, \"bus_label_font_size\": 20, \"bus_label_offset\": [7.0, 15.0],"
+			<< " \"stop_label_font_size\": 20, \"stop_label_offset\": [7.0, -3.0], \"underlayer_color\": [255, 255, 255, 0.85],"
+			<< " \"underlayer_width\": 3.0, \"color_palette\": [\"green\", [255, 160, 0], \"red\", [1, 2, 3, 0.5]]},\n"
+			<< "\"stat_requests\": [\n";
+		for (size_t i = 0; i < feed.requests.size(); ++i) {
+			const RequestData& request = feed.requests[i];
+			out << "{\"id\": " << i << ", \"type\": \"" << request.type << '"';
+			if (!request.name.empty()) {
+				out << ", \"name\": \"" << request.name << '"';
+			};
+			out << (i + 1 == feed.requests.size() ? "}\n" : "},\n");
+		};
+		out << "]}\n";
+		return out.str();
+	}
+
+	//text of feed of about given size, counts of options are scaled to reach it
+	std::string PrintFeed(const FeedOptions& options, size_t megabytes) {
+		const double scale = static_cast<double>(megabytes << 20) / PrintFeed(GenerateFeed(options)).size();
+		FeedOptions scaled = options;
+		scaled.stops = std::max<size_t>(2, static_cast<size_t>(options.stops * scale));
+		scaled.buses = std::max<size_t>(1, static_cast<size_t>(options.buses * scale));
+		scaled.requests = std::max<size_t>(1, static_cast<size_t>(options.requests * scale));
+		return PrintFeed(GenerateFeed(scaled));
+	}
+
+	//printed text is dropped, so only its construction is measured
+	class NullBuffer : public std::streambuf {
+	protected:
+		int_type overflow(int_type c) override {
+			return c;
+		}
+
+		std::streamsize xsputn(const char*, std::streamsize count) override {
+			return count;
+		}
+	};
+
+	//replaces default memory resource while it exists, so only single thread can use it
+	class DefaultResourceCounter {
+	public:
+		DefaultResourceCounter() : previous_(std::pmr::set_default_resource(&counter_)) {
+		}
+
+		~DefaultResourceCounter() {
+			std::pmr::set_default_resource(previous_);
+		}
+
+		size_t GetAllocationsCount() const {
+			return counter_.GetAllocationsCount();
+		}
+
+	private:
+		json::CountingResource counter_;
+		std::pmr::memory_resource* previous_;
+	};
+
+	//adds feed to catalogue as reader does, without parsing
+	void FillCatalogue(const Feed& feed, transport::Catalogue& catalogue) {
+		std::vector<const Stop*> stops;
+		for (const StopData& stop : feed.stops) {
+			stops.push_back(catalogue.AddStop(stop.name, stop.coordinates));
+		};
+		for (size_t i = 0; i < feed.stops.size(); ++i) {
+			for (const auto& [to, length] : feed.stops[i].distances) {
+				catalogue.SetStopsDistance(stops[i], stops[to], length);
+			};
+		};
+		for (const BusData& bus : feed.buses) {
+			const Bus* bus_ptr = catalogue.AddBus(bus.name, bus.is_roundtrip);
+			for (const size_t stop : bus.stops) {
+				catalogue.ExpandBusAndStopInfo(bus_ptr, stops[stop]);
+			};
+		};
+	}
+
+	//catalogue with routes data and reader with stat requests of feed, so only answers are left
+	struct Loaded {
+		transport::Catalogue catalogue;
+		render::MapRenderer renderer;
+		json::JsonReader reader;
+	};
+
+	std::unique_ptr<Loaded> LoadFeed(const std::string& text) {
+		auto loaded = std::make_unique<Loaded>();
+		loaded->reader.LoadData(text, loaded->renderer, loaded->catalogue);
+		loaded->catalogue.CalculateRoutesData();
+		return loaded;
+	}
+
+	//every call starts with empty cache
+	json::AnswerCache::Stats Answer(Loaded& loaded, std::ostream& output, size_t workers_count, size_t cache_capacity) {
+		RequestHandler handler(output, loaded.catalogue, loaded.renderer);
+		handler.SetWorkersCount(workers_count);
+		handler.SetAnswerCacheCapacity(cache_capacity);
+		loaded.reader.StartAnswers(output);
+		handler.ProcessParsedStatRequests(loaded.reader.GetParsedRequests(), loaded.reader);
+		loaded.reader.FinishAnswers();
+		return handler.GetAnswerCacheStats();
+	}
+
+	class Bench {
+	public:
+		explicit Bench(size_t repeats) : repeats_(repeats) {
+		}
+
+		void Title(std::string_view stage) const {
+			std::cout << stage << std::endl;
+		}
+
+		//prepare is not measured, best time of all repeats is printed and returned.
+		//throughput is printed too if bytes are given
+		double Measure(std::string_view name, const std::function<void()>& prepare, const std::function<void()>& run,
+			size_t bytes = 0) const {
+			double best = 0;
+			for (size_t i = 0; i < repeats_; ++i) {
+				prepare();
+				const auto start = std::chrono::steady_clock::now();
+				run();
+				const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+				best = i == 0 ? ms : std::min(best, ms);
+			};
+			std::cout << "    "sv << std::left << std::setw(56) << name << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(10) << best << " ms"sv;
+			if (bytes != 0) {
+				std::cout << std::setw(10) << bytes / (std::max(best, 0.001) * 1e6) << " GB/s"sv;
+			};
+			std::cout << std::endl;
+			return best;
+		}
+
+		//old and new versions get the same preparation, speedup of new one is printed after them
+		void Compare(std::string_view old_name, const std::function<void()>& old_run, std::string_view new_name,
+			const std::function<void()>& new_run, const std::function<void()>& prepare = [] {}, size_t bytes = 0) const {
+			const double old_ms = Measure(old_name, prepare, old_run, bytes);
+			Speedup(old_ms, Measure(new_name, prepare, new_run, bytes));
+		}
+
+		//prints value measured by stage besides time
+		void Report(std::string_view name, size_t value, std::string_view unit) const {
+			std::cout << "    "sv << std::left << std::setw(56) << name << std::right << std::setw(10) << value << (unit.empty() ? ""sv : " "sv) << unit << std::endl;
+		}
+
+		void Speedup(double old_ms, double new_ms) const {
+			std::cout << "    "sv << std::left << std::setw(56) << "speedup"sv << std::right << std::fixed << std::setprecision(2)
+				<< std::setw(10) << old_ms / std::max(new_ms, 0.001) << " x"sv << std::endl;
+		}
+
+	private:
+		size_t repeats_;
+	};
+
+	//both versions must give the same results, otherwise their times cant be compared
+	void CheckSame(bool same, std::string_view stage) {
+		if (!same) {
+			throw std::logic_error("Old and new versions give different results: "s + std::string(stage));
+		};
+	}
+
+	//baseline catalogue searched names in deques one by one
+	void MeasureNameLookup(const Bench& bench, const Feed& feed) {
+		legacy::Catalogue old_catalogue;
+		for (const StopData& stop : feed.stops) {
+			old_catalogue.AddStop(stop.name, stop.coordinates);
+		};
+		for (const BusData& bus : feed.buses) {
+			old_catalogue.AddBus(bus.name, bus.is_roundtrip);
+		};
+		transport::Catalogue catalogue;
+		FillCatalogue(feed, catalogue);
+
+		//linear search is too slow for all requests of big feed
+		const size_t lookups = std::min<size_t>(feed.requests.size(), 2000);
+		size_t old_found = 0;
+		size_t new_found = 0;
+		bench.Title("find stops and buses of "s + std::to_string(lookups) + " requests by names [001]"s);
+		bench.Compare("linear search in deques"sv, [&] {
+			old_found = 0;
+			for (size_t i = 0; i < lookups; ++i) {
+				const RequestData& request = feed.requests[i];
+				old_found += request.type == "Bus"sv ? old_catalogue.FindBus(request.name) != nullptr
+					: old_catalogue.FindStop(request.name) != nullptr;
+			};
+		}, "hash index by names"sv, [&] {
+			new_found = 0;
+			for (size_t i = 0; i < lookups; ++i) {
+				const RequestData& request = feed.requests[i];
+				new_found += request.type == "Bus"sv ? catalogue.FindBus(request.name) != nullptr
+					: catalogue.FindStop(request.name) != nullptr;
+			};
+		});
+		CheckSame(old_found == new_found, "names lookup"sv);
+	}
+
+	//baseline kept distances in unordered_map with hash of chars of both names
+	void MeasureDistances(const Bench& bench, const Feed& feed) {
+		std::unique_ptr<legacy::Catalogue> old_catalogue;
+		std::vector<const legacy::Stop*> old_stops;
+		std::unique_ptr<transport::Catalogue> catalogue;
+		std::vector<const Stop*> stops;
+		const auto add_stops = [&] {
+			old_catalogue = std::make_unique<legacy::Catalogue>();
+			old_stops.clear();
+			catalogue = std::make_unique<transport::Catalogue>();
+			stops.clear();
+			for (const StopData& stop : feed.stops) {
+				old_stops.push_back(old_catalogue->AddStop(stop.name, stop.coordinates));
+				stops.push_back(catalogue->AddStop(stop.name, stop.coordinates));
+			};
+		};
+		const auto set_distances = [&feed](auto& catalogue, const auto& stops) {
+			for (size_t i = 0; i < feed.stops.size(); ++i) {
+				for (const auto& [to, length] : feed.stops[i].distances) {
+					catalogue.SetStopsDistance(stops[i], stops[to], length);
+				};
+			};
+		};
+		const auto sum_distances = [&feed](const auto& catalogue, const auto& stops) {
+			size_t sum = 0;
+			for (size_t i = 0; i < feed.stops.size(); ++i) {
+				for (const auto& distance : feed.stops[i].distances) {
+					sum += catalogue.GetStopsDistance(stops[i], stops[distance.first]);
+				};
+			};
+			return sum;
+		};
+
+		bench.Title("set road distances of all stops [002]"sv);
+		bench.Compare("unordered_map with hash of names"sv, [&] {
+			set_distances(*old_catalogue, old_stops);
+		}, "flat table by stops ids"sv, [&] {
+			set_distances(*catalogue, stops);
+		}, add_stops);
+
+		//every repeat of setting started from empty catalogues
+		add_stops();
+		set_distances(*old_catalogue, old_stops);
+		set_distances(*catalogue, stops);
+		size_t old_sum = 0;
+		size_t new_sum = 0;
+		bench.Title("get road distances of all stops [002]"sv);
+		bench.Compare("unordered_map with hash of names"sv, [&] {
+			old_sum = sum_distances(*old_catalogue, old_stops);
+		}, "flat table by stops ids"sv, [&] {
+			new_sum = sum_distances(*catalogue, stops);
+		});
+		CheckSame(old_sum == new_sum, "road distances"sv);
+	}
+
+	//prepared coordinates keep sin and cos of latitude computed once for every stop, so every segment of
+	//routes needs one cos and one acos instead of five trigonometric functions
+	void MeasureGeoDistance(const Bench& bench, const Feed& feed) {
+		std::vector<geo::PreparedCoordinates> prepared;
+		for (const StopData& stop : feed.stops) {
+			prepared.emplace_back(stop.coordinates);
+		};
+		std::vector<std::pair<size_t, size_t>> segments;
+		for (const BusData& bus : feed.buses) {
+			for (size_t i = 0; i + 1 < bus.stops.size(); ++i) {
+				segments.emplace_back(bus.stops[i], bus.stops[i + 1]);
+			};
+		};
+
+		std::vector<double> old_distances(segments.size());
+		std::vector<double> new_distances(segments.size());
+		bench.Title("geo distances of "s + std::to_string(segments.size()) + " routes segments [016]"s);
+		bench.Compare("ComputeDistance of plain coordinates"sv, [&] {
+			for (size_t i = 0; i < segments.size(); ++i) {
+				old_distances[i] = geo::ComputeDistance(feed.stops[segments[i].first].coordinates,
+					feed.stops[segments[i].second].coordinates);
+			};
+		}, "ComputeDistance of prepared coordinates"sv, [&] {
+			for (size_t i = 0; i < segments.size(); ++i) {
+				new_distances[i] = geo::ComputeDistance(prepared[segments[i].first], prepared[segments[i].second]);
+			};
+		});
+		CheckSame(old_distances == new_distances, "geo distances"sv);
+	}
+
+	std::pair<size_t, size_t> CountRequests(const json::Node& root) {
+		return { root.AsDict().at("base_requests"sv).AsArray().size(), root.AsDict().at("stat_requests"sv).AsArray().size() };
+	}
+
+	//baseline parser read stream char by char, current one walks contiguous buffer once
+	void MeasureParsing(const Bench& bench, const std::string& text) {
+		//roots are released before measuring, so only parsing is timed, and old root is released
+		//before new one is parsed, so big feeds dont need memory for both
+		std::istringstream input;
+		json::Node old_root;
+		json::Node new_root;
+		bench.Title("parse feed of "s + std::to_string((text.size() + (1 << 19)) >> 20) + " MiB [004]"s);
+		const double old_ms = bench.Measure("LoadNode from istream"sv, [&] {
+			input.str(text);
+			input.clear();
+			old_root = json::Node{};
+		}, [&] {
+			old_root = json::LoadNode(input);
+		}, text.size());
+		input.str({});
+		const auto old_counts = CountRequests(old_root);
+		old_root = json::Node{};
+		bench.Speedup(old_ms, bench.Measure("LoadNode from buffer"sv, [&new_root] {
+			new_root = json::Node{};
+		}, [&] {
+			new_root = json::LoadNode(text);
+		}, text.size()));
+		CheckSame(old_counts == CountRequests(new_root), "parsing"sv);
+	}
+
+	//structural index classifies chars of 64 bytes blocks by vector instructions, scalar kernel
+	//classifies them one by one. whole indexer finds positions of tokens by these masks
+	void MeasureStructuralIndex(const Bench& bench, const std::string& text) {
+		const size_t blocks_count = text.size() / json::StructuralIndexer::BLOCK_SIZE;
+		const size_t blocks_bytes = blocks_count * json::StructuralIndexer::BLOCK_SIZE;
+		const json::MasksKernel kernel = json::GetBestMasksKernel();
+		std::vector<json::BlockMasks> old_masks(blocks_count);
+		std::vector<json::BlockMasks> new_masks(blocks_count);
+		bench.Title("structural index of feed of "s + std::to_string((text.size() + (1 << 19)) >> 20) + " MiB [022]"s);
+		bench.Compare("masks by SCALAR kernel"sv, [&] {
+			json::ComputeBlocksMasks(json::MasksKernel::SCALAR, text.data(), blocks_count, old_masks.data());
+		}, kernel == json::MasksKernel::AVX2 ? "masks by AVX2 kernel"sv : kernel == json::MasksKernel::SSE2 ? "masks by SSE2 kernel"sv
+			: "masks by SCALAR kernel"sv, [&] {
+			json::ComputeBlocksMasks(kernel, text.data(), blocks_count, new_masks.data());
+		}, [] {}, blocks_bytes);
+		CheckSame(std::equal(old_masks.begin(), old_masks.end(), new_masks.begin(),
+			[](const json::BlockMasks& lhs, const json::BlockMasks& rhs) {
+				return lhs.quotes == rhs.quotes && lhs.backslashes == rhs.backslashes && lhs.operators == rhs.operators
+					&& lhs.whitespaces == rhs.whitespaces;
+			}), "structural masks"sv);
+
+		size_t positions = 0;
+		bench.Measure("positions of tokens by StructuralIndexer"sv, [&positions] {
+			positions = 0;
+		}, [&] {
+			json::StructuralIndexer indexer(text);
+			while (!indexer.IsFinished()) {
+				positions += indexer.IndexNext();
+			};
+		}, text.size());
+		bench.Report("positions of tokens"sv, positions, ""sv);
+	}
+
+	//baseline allocated every array and dict from heap and released them one by one, document takes
+	//big chunks for them from heap and releases them at once. only memory of arrays and dicts is counted,
+	//strings of old tree are copied to heap, strings of document are views to feed
+	void MeasureArena(const Bench& bench, const std::string& text) {
+		size_t old_allocations = 0;
+		size_t old_peak = 0;
+		json::Document::MemoryStats new_stats;
+		bench.Title("parse and release feed of "s + std::to_string((text.size() + (1 << 19)) >> 20) + " MiB [006]"s);
+		bench.Compare("LoadNode with nodes from heap"sv, [&] {
+			json::CountingResource heap;
+			{
+				const json::Node root = json::LoadNode(text, &heap);
+			}
+			old_allocations = heap.GetAllocationsCount();
+			old_peak = heap.GetPeakBytes();
+		}, "Document with nodes in arena"sv, [&] {
+			const json::Document document = json::Document::Borrow(text);
+			new_stats = document.GetMemoryStats();
+		}, [] {}, text.size());
+		bench.Report("heap allocations of nodes, old"sv, old_allocations, ""sv);
+		bench.Report("heap allocations of nodes, new (arena chunks)"sv, new_stats.heap_allocations, ""sv);
+		bench.Report("heap peak of nodes, old"sv, old_peak >> 10, "KiB"sv);
+		bench.Report("heap peak of nodes, new"sv, new_stats.heap_peak_bytes >> 10, "KiB"sv);
+		bench.Report("nodes allocations in arena"sv, new_stats.nodes_allocations, ""sv);
+		bench.Report("nodes bytes in arena"sv, new_stats.nodes_bytes >> 10, "KiB"sv);
+	}
+
+	//reads every value of feed as reader does, sum of values is the same for trees of both versions
+	template <typename Node>
+	double WalkFeed(const Node& root) {
+		const auto text = [](const Node& node) {
+			return node.IsString() ? std::string_view(node.AsString()) : node.AsStringView();
+		};
+		double sum = 0;
+		for (const Node& request : root.AsDict().at("base_requests").AsArray()) {
+			const auto& dict = request.AsDict();
+			sum += text(dict.at("name")).size();
+			if (text(dict.at("type")) == "Stop"sv) {
+				sum += dict.at("latitude").AsDouble() + dict.at("longitude").AsDouble();
+				for (const auto& distance : dict.at("road_distances").AsDict()) {
+					sum += distance.second.AsInt();
+				};
+			}
+			else {
+				sum += dict.at("is_roundtrip").AsBool();
+				for (const Node& stop : dict.at("stops").AsArray()) {
+					sum += text(stop).size();
+				};
+			};
+		};
+		for (const Node& request : root.AsDict().at("stat_requests").AsArray()) {
+			const auto& dict = request.AsDict();
+			sum += dict.at("id").AsInt() + text(dict.at("type")).size() + (dict.count("name") ? text(dict.at("name")).size() : 0);
+		};
+		return sum;
+	}
+
+	//baseline dicts were std::map with node for every key, current ones are sorted vectors. trees are built
+	//by parsers of their versions, which are compared by parsing stage, so only access is measured here
+	void MeasureDictAccess(const Bench& bench, const std::string& text) {
+		std::istringstream input(text);
+		const legacy::json::Node old_root = legacy::json::LoadNode(input);
+		const json::Document document = json::Document::Borrow(text);
+		double old_sum = 0;
+		double new_sum = 0;
+		bench.Title("read all values of parsed feed [007]"sv);
+		bench.Compare("std::map dicts"sv, [&] {
+			old_sum = WalkFeed(old_root);
+		}, "flat sorted dicts"sv, [&] {
+			new_sum = WalkFeed(document.GetRoot());
+		});
+		CheckSame(old_sum == new_sum, "dicts access"sv);
+	}
+
+	//baseline printer passed every char and number to stream, writer formats them in its own buffer
+	//and passes big blocks to stream. old printer keeps only 6 digits of doubles, so printed feeds
+	//are checked by counts of requests
+	void MeasurePrinting(const Bench& bench, const std::string& text) {
+		std::istringstream input(text);
+		const legacy::json::Node old_root = legacy::json::LoadNode(input);
+		const json::Document document = json::Document::Borrow(text);
+		NullBuffer null_buffer;
+		std::ostream null_stream(&null_buffer);
+		bench.Title("print parsed feed to nowhere [008]"sv);
+		bench.Compare("PrintJson to stream"sv, [&] {
+			legacy::json::PrintJson(old_root, null_stream);
+		}, "PrintJson through Writer"sv, [&] {
+			json::PrintJson(document.GetRoot(), null_stream);
+		});
+
+		std::ostringstream old_text;
+		legacy::json::PrintJson(old_root, old_text);
+		std::ostringstream new_text;
+		json::PrintJson(document.GetRoot(), new_text);
+		CheckSame(CountRequests(json::LoadNode(old_text.str())) == CountRequests(json::LoadNode(new_text.str())), "printing"sv);
+	}
+
+	//reader walks document by references, copy of any array or dict of it would take memory from default resource
+	void MeasureDocumentWalk(const Bench& bench, const std::string& text) {
+		std::unique_ptr<json::JsonReader> reader;
+		std::unique_ptr<render::MapRenderer> renderer;
+		size_t copies_allocations = 0;
+		bench.Title("load feed to reader in document mode [010]"sv);
+		bench.Measure("parse document and walk it by references"sv, [&] {
+			reader = std::make_unique<json::JsonReader>();
+			renderer = std::make_unique<render::MapRenderer>();
+		}, [&] {
+			DefaultResourceCounter counter;
+			reader->LoadData(text, *renderer);
+			copies_allocations = counter.GetAllocationsCount();
+		});
+		const json::JsonReader::LoadStats& stats = reader->GetLoadStats();
+		bench.Report("nodes allocations in arena"sv, stats.document.nodes_allocations, ""sv);
+		bench.Report("arena chunks"sv, stats.document.heap_allocations, ""sv);
+		bench.Report("allocations of walk"sv, stats.walk_allocations, ""sv);
+		bench.Report("allocations of copied nodes"sv, copies_allocations, ""sv);
+	}
+
+	//same feed, but stat requests repeat hot_count of them after first map request, as popular names
+	//are asked again and again
+	Feed RepeatRequests(const Feed& feed, size_t hot_count) {
+		Feed repeated = feed;
+		for (size_t i = hot_count + 1; i < repeated.requests.size(); ++i) {
+			repeated.requests[i] = feed.requests[1 + i % hot_count];
+		};
+		return repeated;
+	}
+
+	//without cache answer for every request is constructed and serialized again
+	void MeasureAnswerCache(const Bench& bench, Loaded& loaded, std::string_view requests_kind) {
+		NullBuffer null_buffer;
+		std::ostream null_stream(&null_buffer);
+		json::AnswerCache::Stats stats;
+		bench.Title("answer "s + std::to_string(loaded.reader.GetParsedRequests().size()) + " "s + std::string(requests_kind)
+			+ " stat requests, 1 thread [012]"s);
+		bench.Compare("without cache"sv, [&] {
+			Answer(loaded, null_stream, 1, 0);
+		}, "with cache of "s + std::to_string(json::AnswerCache::DEFAULT_CAPACITY) + " answers"s, [&] {
+			stats = Answer(loaded, null_stream, 1, json::AnswerCache::DEFAULT_CAPACITY);
+		});
+		bench.Report("cache hits"sv, stats.hits, ""sv);
+		bench.Report("cache misses"sv, stats.misses, ""sv);
+
+		std::ostringstream old_answers;
+		Answer(loaded, old_answers, 1, 0);
+		std::ostringstream new_answers;
+		Answer(loaded, new_answers, 1, json::AnswerCache::DEFAULT_CAPACITY);
+		CheckSame(old_answers.str() == new_answers.str(), "answers cache"sv);
+	}
+
+	//workers share cache of answers, misses of different names must not wait for each other. every count
+	//of workers gives the same answers as one thread
+	void MeasureAnswerWorkers(const Bench& bench, Loaded& loaded, std::string_view requests_kind, size_t max_workers) {
+		NullBuffer null_buffer;
+		std::ostream null_stream(&null_buffer);
+		bench.Title("answer "s + std::to_string(loaded.reader.GetParsedRequests().size()) + " "s + std::string(requests_kind)
+			+ " stat requests by 1.."s + std::to_string(max_workers) + " workers with cache [013]"s);
+		std::ostringstream single_answers;
+		Answer(loaded, single_answers, 1, json::AnswerCache::DEFAULT_CAPACITY);
+		double single_ms = 0;
+		double best_ms = 0;
+		for (size_t workers = 1; workers <= max_workers; ++workers) {
+			const double ms = bench.Measure(std::to_string(workers) + (workers == 1 ? " worker"s : " workers"s), [] {}, [&] {
+				Answer(loaded, null_stream, workers, json::AnswerCache::DEFAULT_CAPACITY);
+			});
+			single_ms = workers == 1 ? ms : single_ms;
+			best_ms = workers == 1 ? ms : std::min(best_ms, ms);
+
+			std::ostringstream answers;
+			Answer(loaded, answers, workers, json::AnswerCache::DEFAULT_CAPACITY);
+			CheckSame(single_answers.str() == answers.str(), "answers by workers"sv);
+		};
+		bench.Speedup(single_ms, best_ms);
+	}
+
+	//on demand only data of requested bus is calculated before its answer, eager mode calculates data of all buses
+	//after loading. catalogue is released before next repeat, so its release is not measured
+	void MeasureFirstBusAnswer(const Bench& bench, const std::string& text) {
+		std::unique_ptr<Loaded> loaded;
+		const auto answer_first_bus = [&](bool on_demand, std::ostream& output) {
+			loaded = std::make_unique<Loaded>();
+			loaded->reader.LoadData(text, loaded->renderer, loaded->catalogue);
+			if (on_demand) {
+				loaded->catalogue.PrepareRoutesDataOnDemand();
+			}
+			else {
+				loaded->catalogue.CalculateRoutesData();
+			};
+			const std::vector<Request>& requests = loaded->reader.GetParsedRequests();
+			const auto first_bus = std::find_if(requests.begin(), requests.end(),
+				[](const Request& request) { return request.type == "Bus"s; });
+			RequestHandler handler(output, loaded->catalogue, loaded->renderer);
+			loaded->reader.StartAnswers(output);
+			handler.ProcessParsedStatRequests(std::vector<Request>(first_bus, std::next(first_bus)), loaded->reader);
+			loaded->reader.FinishAnswers();
+		};
+
+		NullBuffer null_buffer;
+		std::ostream null_stream(&null_buffer);
+		bench.Title("load feed and answer first bus request [015]"s);
+		bench.Compare("routes data of all buses, EAGER"sv, [&] {
+			answer_first_bus(false, null_stream);
+		}, "routes data on demand, ON_DEMAND"sv, [&] {
+			answer_first_bus(true, null_stream);
+		}, [&] {
+			loaded.reset();
+		});
+
+		std::ostringstream old_answer;
+		answer_first_bus(false, old_answer);
+		std::ostringstream new_answer;
+		answer_first_bus(true, new_answer);
+		CheckSame(old_answer.str() == new_answer.str(), "first bus answer"sv);
+	}
+
+	void Run(const FeedOptions& options, const Feed& feed, const std::vector<size_t>& parse_sizes, size_t repeats, size_t workers) {
+		const Bench bench(repeats);
+		MeasureNameLookup(bench, feed);
+		MeasureDistances(bench, feed);
+		MeasureGeoDistance(bench, feed);
+		const std::string text = PrintFeed(feed);
+		MeasureDictAccess(bench, text);
+		MeasurePrinting(bench, text);
+		MeasureDocumentWalk(bench, text);
+		MeasureFirstBusAnswer(bench, text);
+
+		const std::unique_ptr<Loaded> loaded = LoadFeed(text);
+		MeasureAnswerCache(bench, *loaded, "random"sv);
+		const std::unique_ptr<Loaded> repeated = LoadFeed(PrintFeed(RepeatRequests(feed, 500)));
+		MeasureAnswerCache(bench, *repeated, "repeated"sv);
+		MeasureAnswerWorkers(bench, *loaded, "random"sv, workers);
+		MeasureAnswerWorkers(bench, *repeated, "repeated"sv, workers);
+		for (const size_t megabytes : parse_sizes) {
+			const std::string text = PrintFeed(options, megabytes);
+			MeasureParsing(bench, text);
+			MeasureStructuralIndex(bench, text);
+			MeasureArena(bench, text);
+		};
+	}
+
+	//returns 0 if text is not a decimal number, 0 is not a valid count anyway
+	size_t ParseCount(std::string_view text) {
+		size_t count{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+		return error == std::errc{} && end == text.data() + text.size() ? count : 0;
+	}
+
+	//comma separated counts, empty vector if any of them is wrong
+	std::vector<size_t> ParseCounts(std::string_view text) {
+		std::vector<size_t> counts;
+		while (true) {
+			const size_t comma = text.find(',');
+			const size_t count = ParseCount(text.substr(0, comma));
+			if (count == 0) {
+				return {};
+			};
+			counts.push_back(count);
+			if (comma == text.npos) {
+				return counts;
+			};
+			text.remove_prefix(comma + 1);
+		};
+	}
+}
+
+int main(int argc, char* argv[]) {
+	FeedOptions options;
+	size_t repeats = 3;
+	//sizes of feeds for parsing in megabytes, 1000 needs several gigabytes of memory for nodes
+	std::vector<size_t> parse_sizes = { 1, 100 };
+	//feed is written to file if path is given, so it can be passed to transport_catalogue too
+	std::string feed_path;
+	//answers are measured by every count of workers up to this one
+	size_t workers = std::max(4u, std::thread::hardware_concurrency());
+	for (int i = 1; i < argc; i += 2) {
+		const std::string_view option = argv[i];
+		size_t* count = option == "--stops"sv ? &options.stops
+			: option == "--buses"sv ? &options.buses
+			: option == "--requests"sv ? &options.requests
+			: option == "--seed"sv ? &options.seed
+			: option == "--repeats"sv ? &repeats
+			: option == "--workers"sv ? &workers
+			: nullptr;
+		const size_t value = i + 1 == argc ? 0 : ParseCount(argv[i + 1]);
+		if (option == "--feed"sv && i + 1 < argc) {
+			feed_path = argv[i + 1];
+		}
+		else if (option == "--parse-mb"sv && i + 1 < argc && !ParseCounts(argv[i + 1]).empty()) {
+			parse_sizes = ParseCounts(argv[i + 1]);
+		}
+		else if (count == nullptr || value == 0) {
+			std::cerr << "Usage: " << argv[0] << " [--stops <count>] [--buses <count>] [--requests <count>] [--seed <number>]"
+				<< " [--repeats <count>] [--workers <count>] [--parse-mb <megabytes,...>] [--feed <path>]" << std::endl;
+			return 1;
+		}
+		else {
+			*count = value;
+		};
+	};
+
+	try {
+		const Feed feed = GenerateFeed(options);
+		std::cout << "feed: " << options.stops << " stops, " << options.buses << " buses, " << options.requests
+			<< " requests" << std::endl;
+		if (!feed_path.empty()) {
+			std::ofstream(feed_path, std::ios::binary) << PrintFeed(feed);
+		};
+		Run(options, feed, parse_sizes, repeats, workers);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	};
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#include "legacy.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace legacy {
+	Stop::Stop(const std::string& stop, const geo::Coordinates& init_coordinates) :
+		name(stop), coordinates(init_coordinates) {
+	}
+
+	bool Stop::operator==(const std::string& other_stop) const {
+		return other_stop == name;
+	}
+
+	Bus::Bus(const std::string& bus, bool is_round) : name(bus), is_roundtrip(is_round) {
+	}
+
+	bool Bus::operator==(const std::string& other_bus) const {
+		return other_bus == name;
+	}
+
+	StopsPtrsPair::StopsPtrsPair(const Stop* ptr1, const Stop* ptr2) : first(ptr1), second(ptr2) {
+	}
+
+	bool StopsPtrsPair::operator==(const StopsPtrsPair& other_stops) const {
+		return (other_stops.first == first) && (other_stops.second == second);
+	}
+
+	size_t StopsPtrsPairHasher::operator()(const StopsPtrsPair& stops_pair) const {
+		int index{}, i{ 1 };
+		for (const char c : (stops_pair.first->name + stops_pair.second->name)) {
+			index += (c - '0') * static_cast<int>(std::pow(37, i));
+			++i;
+		};
+		return static_cast<size_t>(index);
+	}
+
+	const Stop* Catalogue::AddStop(const std::string& name, const geo::Coordinates& point) {
+		return &stops_.emplace_back(name, point);
+	}
+
+	const Bus* Catalogue::AddBus(const std::string& name, const bool is_roundtrip) {
+		return &buses_.emplace_back(name, is_roundtrip);
+	}
+
+	const Stop* Catalogue::FindStop(const std::string& stop) const {
+		auto search_res = std::find(stops_.begin(), stops_.end(), stop);
+		return search_res == stops_.end() ? nullptr : &(*search_res);
+	}
+
+	const Bus* Catalogue::FindBus(const std::string& bus) const {
+		auto search_res = std::find(buses_.begin(), buses_.end(), bus);
+		return search_res == buses_.end() ? nullptr : &(*search_res);
+	}
+
+	void Catalogue::SetStopsDistance(const Stop* a, const Stop* b, const size_t length) {
+		routes_lengths_[StopsPtrsPair(a, b)] = length;
+	}
+
+	size_t Catalogue::GetStopsDistance(const Stop* a, const Stop* b) const {
+		return routes_lengths_.at(StopsPtrsPair(a, b));
+	}
+}//end of namespace legacy
\ No newline at end of file
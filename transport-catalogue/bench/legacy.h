@@ -0,0 +1,63 @@
+#pragma once
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+#include "../geo.h"
+
+//parts of baseline version which were replaced by backlog requests, they are kept
+//only to be measured against their replacements on the same feed
+namespace legacy {
+	struct Stop {
+		Stop(const std::string& stop, const geo::Coordinates& init_coordinates);
+
+		bool operator==(const std::string& other_stop) const;
+
+		std::string name;
+		geo::Coordinates coordinates;
+	};
+
+	struct Bus {
+		Bus(const std::string& bus, bool is_round);
+
+		bool operator==(const std::string& other_bus) const;
+
+		std::string name;
+		bool is_roundtrip;
+	};
+
+	struct StopsPtrsPair {
+		StopsPtrsPair(const Stop* ptr1, const Stop* ptr2);
+
+		bool operator==(const StopsPtrsPair& other_stops) const;
+
+		const Stop* first{};
+		const Stop* second{};
+	};
+
+	//hashes chars of both names, so every lookup concatenates names and pairs with close names collide
+	struct StopsPtrsPairHasher {
+		size_t operator()(const StopsPtrsPair& stops_pair) const;
+	};
+
+	//objects are kept in deques and found by linear search
+	class Catalogue {
+	public:
+		const Stop* AddStop(const std::string& name, const geo::Coordinates& point);
+
+		const Bus* AddBus(const std::string& name, const bool is_roundtrip);
+
+		const Stop* FindStop(const std::string& stop) const;
+
+		const Bus* FindBus(const std::string& bus) const;
+
+		void SetStopsDistance(const Stop* a, const Stop* b, const size_t length);
+
+		size_t GetStopsDistance(const Stop* a, const Stop* b) const;
+
+	private:
+		std::unordered_map<const StopsPtrsPair, size_t, StopsPtrsPairHasher> routes_lengths_{};
+		std::deque<Stop> stops_{};
+		std::deque<Bus> buses_{};
+	};
+}//end of namespace legacy
\ No newline at end of file
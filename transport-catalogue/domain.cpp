@@ -1,8 +1,85 @@
 #include "domain.h"
 
+#include <algorithm>
+
 namespace objects {
 
-	Bus::Bus(const std::string& bus, bool is_round) : name(bus), is_roundtrip(is_round) {
+	IdsRange::IdsRange(const uint32_t* first, const uint32_t* last) : first_(first), last_(last) {
+	}
+
+	const uint32_t* IdsRange::begin() const {
+		return first_;
+	}
+
+	const uint32_t* IdsRange::end() const {
+		return last_;
+	}
+
+	size_t IdsRange::size() const {
+		return static_cast<size_t>(last_ - first_);
+	}
+
+	bool IdsRange::empty() const {
+		return first_ == last_;
+	}
+
+	RouteView::Iterator::Iterator(const RouteView* route, size_t index) : route_(route), index_(index) {
+	}
+
+	uint32_t RouteView::Iterator::operator*() const {
+		return (*route_)[index_];
+	}
+
+	RouteView::Iterator& RouteView::Iterator::operator++() {
+		++index_;
+		return *this;
+	}
+
+	bool RouteView::Iterator::operator==(const Iterator& other) const {
+		return index_ == other.index_;
+	}
+
+	bool RouteView::Iterator::operator!=(const Iterator& other) const {
+		return index_ != other.index_;
+	}
+
+	RouteView::RouteView(IdsRange stops, bool is_roundtrip) : stops_(stops), is_roundtrip_(is_roundtrip) {
+	}
+
+	size_t RouteView::size() const {
+		const size_t count = stops_.size();
+		if (is_roundtrip_ || count == 0) {
+			return count;
+		};
+		return count == 1 ? 2 : count * 2 - 1;
+	}
+
+	bool RouteView::empty() const {
+		return stops_.empty();
+	}
+
+	uint32_t RouteView::operator[](size_t index) const {
+		const size_t count = stops_.size();
+		if (index < count) {
+			return stops_.begin()[index];
+		};
+		//way back of not roundtrip route
+		return stops_.begin()[count == 1 ? 0 : count * 2 - 2 - index];
+	}
+
+	RouteView::Iterator RouteView::begin() const {
+		return Iterator(this, 0);
+	}
+
+	RouteView::Iterator RouteView::end() const {
+		return Iterator(this, size());
+	}
+
+	IdsRange RouteView::Stops() const {
+		return stops_;
+	}
+
+	Bus::Bus(std::string_view bus, bool is_round, uint32_t bus_id) : id(bus_id), name(bus), is_roundtrip(is_round) {
 	}
 
 	bool Bus::operator==(const std::string& other_bus) {
@@ -13,8 +90,8 @@ namespace objects {
 		return lhs->name < rhs->name;
 	}
 
-	Stop::Stop(const std::string& stop, const geo::Coordinates& init_coordinates) :
-		name(stop), coordinates(init_coordinates) {
+	Stop::Stop(std::string_view stop, const geo::PreparedCoordinates& init_coordinates, uint32_t stop_id) :
+		id(stop_id), name(stop), coordinates(init_coordinates) {
 	}
 
 	bool Stop::operator==(const std::string& other_stop) {
@@ -25,20 +102,94 @@ namespace objects {
 		return lhs->name < rhs->name;
 	}
 
-	StopsPtrsPair::StopsPtrsPair(const Stop* ptr1, const Stop* ptr2) : first(ptr1), second(ptr2) {
+	void StopsDistanceTable::Set(uint32_t from, uint32_t to, size_t length) {
+		//keeping load factor not greater than 1/2, so probe sequences stay short
+		if ((size_ + 1) * 2 > slots_.size()) {
+			Rehash(slots_.empty() ? 16 : slots_.size() * 2);
+		};
+		const uint64_t key = MakeKey(from, to);
+		Slot& slot = slots_[FindSlot(key)];
+		if (slot.key == EMPTY_KEY) {
+			slot.key = key;
+			++size_;
+		};
+		slot.length = length;
+	}
+
+	const size_t* StopsDistanceTable::Find(uint32_t from, uint32_t to) const {
+		if (slots_.empty()) {
+			return nullptr;
+		};
+		const Slot& slot = slots_[FindSlot(MakeKey(from, to))];
+		return slot.key == EMPTY_KEY ? nullptr : &slot.length;
+	}
+
+	size_t StopsDistanceTable::At(uint32_t from, uint32_t to) const {
+		const size_t* length = Find(from, to);
+		if (length == nullptr) {
+			throw std::out_of_range("Distance between stops is not set");
+		};
+		return *length;
+	}
+
+	size_t StopsDistanceTable::Size() const {
+		return size_;
+	}
+
+	const std::vector<StopsDistanceTable::Slot>& StopsDistanceTable::GetSlots() const {
+		return slots_;
+	}
+
+	StopsDistanceTable StopsDistanceTable::FromSlots(std::vector<Slot> slots, size_t stops_count) {
+		const size_t count = slots.size();
+		if ((count & (count - 1)) != 0) {
+			throw std::invalid_argument("Count of distances slots is not a power of two");
+		};
+		StopsDistanceTable table;
+		for (const Slot& slot : slots) {
+			if (slot.key == EMPTY_KEY) {
+				continue;
+			};
+			if ((slot.key >> 32) >= stops_count || (slot.key & 0xFFFFFFFFULL) >= stops_count) {
+				throw std::invalid_argument("Distance refers to stop which is not in catalogue");
+			};
+			++table.size_;
+		};
+		//same limit as in Set, so table which has no empty slot is rejected too
+		if (table.size_ * 2 > count) {
+			throw std::invalid_argument("Distances table is filled over load factor");
+		};
+		table.slots_ = std::move(slots);
+		return table;
 	}
 
-	bool StopsPtrsPair::operator==(const StopsPtrsPair& other_stops) const {
-		return (other_stops.first == first) && (other_stops.second == second);
+	uint64_t StopsDistanceTable::MakeKey(uint32_t from, uint32_t to) {
+		return (static_cast<uint64_t>(from) << 32) | to;
+	}
+
+	size_t StopsDistanceTable::FindSlot(uint64_t key) const {
+		//mixing bits of both ids (murmur3 finalizer), capacity is always a power of two
+		uint64_t hash = key;
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		const size_t mask = slots_.size() - 1;
+		size_t index = static_cast<size_t>(hash) & mask;
+		//linear probing until key or empty slot is found, table always has empty slots
+		while (slots_[index].key != key && slots_[index].key != EMPTY_KEY) {
+			index = (index + 1) & mask;
+		};
+		return index;
 	}
 
-	size_t StopsPtrsPairHasher::operator()(const StopsPtrsPair& stops_pair) const {
-		int index{}, i{ 1 };
-		for (const char c : (stops_pair.first->name + stops_pair.second->name)) {
-			index += (c - '0') * static_cast<int>(std::pow(37, i));
-			++i;
+	void StopsDistanceTable::Rehash(size_t new_capacity) {
+		std::vector<Slot> old_slots(new_capacity);
+		old_slots.swap(slots_);
+		for (const Slot& slot : old_slots) {
+			if (slot.key != EMPTY_KEY) {
+				slots_[FindSlot(slot.key)] = slot;
+			};
 		};
-		return static_cast<size_t>(index);
 	}
 
 }
\ No newline at end of file
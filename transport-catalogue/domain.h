@@ -1,10 +1,15 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <cmath>
 #include <string_view>
 #include <vector>
 #include <set>
 #include <variant>
+#include <stdexcept>
+#include <iterator>
+#include <cstddef>
+#include <deque>
 
 #include "geo.h"
 
@@ -16,32 +21,183 @@ namespace objects {
 		double curvature{};
 	};
 
-	struct Stop;
+	//view to a part of flat array of dense ids
+	class IdsRange {
+	public:
+		IdsRange(const uint32_t* first, const uint32_t* last);
 
+		const uint32_t* begin() const;
+
+		const uint32_t* end() const;
+
+		size_t size() const;
+
+		bool empty() const;
+
+	private:
+		const uint32_t* first_{};
+		const uint32_t* last_{};
+	};
+
+	//objects with dense ids, they are kept in deque by built catalogue and in array by loaded one
+	template <typename Object>
+	class ObjectsView {
+	public:
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Object;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const Object*;
+			using reference = const Object&;
+
+			Iterator(const ObjectsView* objects, size_t index) : objects_(objects), index_(index) {
+			}
+
+			const Object& operator*() const {
+				return (*objects_)[index_];
+			}
+
+			Iterator& operator++() {
+				++index_;
+				return *this;
+			}
+
+			bool operator==(const Iterator& other) const {
+				return index_ == other.index_;
+			}
+
+			bool operator!=(const Iterator& other) const {
+				return index_ != other.index_;
+			}
+
+		private:
+			const ObjectsView* objects_;
+			size_t index_;
+		};
+
+		ObjectsView() = default;
+
+		explicit ObjectsView(const std::deque<Object>& objects) : deque_(&objects) {
+		}
+
+		ObjectsView(const Object* objects, size_t count) : array_(objects), count_(count) {
+		}
+
+		const Object& operator[](size_t index) const {
+			return deque_ != nullptr ? (*deque_)[index] : array_[index];
+		}
+
+		size_t size() const {
+			return deque_ != nullptr ? deque_->size() : count_;
+		}
+
+		Iterator begin() const {
+			return Iterator(this, 0);
+		}
+
+		Iterator end() const {
+			return Iterator(this, size());
+		}
+
+	private:
+		const std::deque<Object>* deque_ = nullptr;
+		const Object* array_ = nullptr;
+		size_t count_ = 0;
+	};
+
+	//stops ids in order of bus movement, stops of not roundtrip route are passed
+	//there and back: A B C is viewed as A B C B A, single stop A is viewed as A A
+	class RouteView {
+	public:
+		class Iterator {
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = uint32_t;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const uint32_t*;
+			using reference = uint32_t;
+
+			Iterator(const RouteView* route, size_t index);
+
+			uint32_t operator*() const;
+
+			Iterator& operator++();
+
+			bool operator==(const Iterator& other) const;
+
+			bool operator!=(const Iterator& other) const;
+
+		private:
+			const RouteView* route_;
+			size_t index_;
+		};
+
+		RouteView(IdsRange stops, bool is_roundtrip);
+
+		size_t size() const;
+
+		bool empty() const;
+
+		uint32_t operator[](size_t index) const;
+
+		Iterator begin() const;
+
+		Iterator end() const;
+
+		//stops as they are given, way back is not included
+		IdsRange Stops() const;
+
+	private:
+		IdsRange stops_;
+		bool is_roundtrip_;
+	};
+
+	//chars of names are kept by catalogue or by loaded snapshot
 	struct Bus {
-		Bus(const std::string& bus, bool is_round);
+		Bus(std::string_view bus, bool is_round, uint32_t bus_id);
 
 		bool operator==(const std::string& other_bus);
 
-		std::string name;
+		uint32_t id{}; //dense index of bus in catalogue
+		std::string_view name;
 		bool is_roundtrip;
-		std::vector<const Stop*> stops{};
+		//route is kept by catalogue in shared arrays of all routes: dense ids of route stops as they are given
+		//(way back is not stored) and ids of segments between neighbour stops of whole route
+		uint32_t stops_begin{};
+		uint32_t stops_count{};
+		uint32_t edges_begin{};
+		uint32_t edges_count{};
 		RouteData route_data;
 	};
 
+	//bus with its route taken from catalogue
+	struct BusRoute {
+		const Bus* bus;
+		RouteView route;
+	};
+
+	//directed segment between neighbour stops of routes, same for all buses which pass it
+	struct Edge {
+		uint32_t from{}; //stops ids
+		uint32_t to{};
+		size_t road_length{}; //length set for segment, or for reversed one if it is not set, or 0
+		double geo_length{};
+	};
+
 	struct BusPtrComp
 	{
 		bool operator()(const Bus* lhs, const Bus* rhs) const;
 	};
 
 	struct Stop {
-		Stop(const std::string& stop, const geo::Coordinates& init_coordinates);
+		Stop(std::string_view stop, const geo::PreparedCoordinates& init_coordinates, uint32_t stop_id);
 
 		bool operator==(const std::string& other_stop);
 
-		std::string name;
-		geo::Coordinates coordinates;
-		std::set<const Bus*, BusPtrComp> buses{};
+		uint32_t id{}; //dense index of stop in catalogue
+		std::string_view name;
+		geo::PreparedCoordinates coordinates; //trigonometry is computed once when stop is added
 	};
 
 	struct StopPtrComp
@@ -49,17 +205,43 @@ namespace objects {
 		bool operator()(const Stop* lhs, const Stop* rhs) const;
 	};
 
-	struct StopsPtrsPair {
-		StopsPtrsPair(const Stop* ptr1, const Stop* ptr2);
+	//open addressing hash table of distances between stops,
+	//key is a pair of dense stops ids packed into one 64-bit number
+	class StopsDistanceTable {
+	public:
+		void Set(uint32_t from, uint32_t to, size_t length);
 
-		bool operator==(const StopsPtrsPair& other_stops) const;
+		//returns nullptr if distance is not set
+		const size_t* Find(uint32_t from, uint32_t to) const;
 
-		const Stop* first{};
-		const Stop* second{};
-	};
+		size_t At(uint32_t from, uint32_t to) const;
+
+		size_t Size() const;
+
+		static constexpr uint64_t EMPTY_KEY = ~uint64_t{ 0 };
+
+		struct Slot {
+			uint64_t key = EMPTY_KEY;
+			size_t length{};
+		};
+
+		//slots as they are placed in table, so table can be saved and loaded without rehashing
+		const std::vector<Slot>& GetSlots() const;
+
+		//table with slots as they were placed in other table. slots are checked, so every lookup ends and every key
+		//refers to stops with ids less than stops_count: count of slots is a power of two or 0 and no more than a half
+		//of slots is used, so empty slot is always met
+		static StopsDistanceTable FromSlots(std::vector<Slot> slots, size_t stops_count);
+
+	private:
+		std::vector<Slot> slots_{};
+		size_t size_{};
+
+		static uint64_t MakeKey(uint32_t from, uint32_t to);
+
+		size_t FindSlot(uint64_t key) const;
 
-	struct StopsPtrsPairHasher {
-		size_t operator()(const StopsPtrsPair& stops_pair) const;
+		void Rehash(size_t new_capacity);
 	};
 
 	struct Request {
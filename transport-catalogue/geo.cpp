@@ -1,15 +1,274 @@
 #include "geo.h"
 #include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <emmintrin.h>
+#endif
 
 namespace geo {
+	namespace {
+		const double dr = 3.1415926535 / 180.0;
+		const double earth_radius = 6371000.0;
+
+		void ComputeDistancesScalar(const PointsArrays& from, const PointsArrays& to, size_t count, double* distances) {
+			for (size_t i = 0; i < count; ++i) {
+				if (from.lat[i] == to.lat[i] && from.lng[i] == to.lng[i]) {
+					distances[i] = 0;
+					continue;
+				};
+				const double cos_angle = from.sin_lat[i] * to.sin_lat[i]
+					+ from.cos_lat[i] * to.cos_lat[i] * std::cos(std::abs(from.lng[i] - to.lng[i]) * dr);
+				distances[i] = std::acos(std::fmin(std::fmax(cos_angle, -1.0), 1.0)) * earth_radius;
+			};
+		}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+		//gcc vector extensions, same code is compiled for SSE2 with 2 doubles and for AVX2 with 4 doubles.
+		//functions with AVX vectors are always inlined into AVX2 function. vectors are passed by reference
+		//and results are returned by out parameters, so no vector is passed by value outside AVX2 function
+		typedef double Double2 __attribute__((vector_size(16)));
+		typedef int64_t Int2 __attribute__((vector_size(16)));
+		typedef double Double4 __attribute__((vector_size(32)));
+		typedef int64_t Int4 __attribute__((vector_size(32)));
+
+		//coefficients of cephes library polynomials
+		const double SIN_COEFFICIENTS[] = { 1.58962301576546568060E-10, -2.50507477628578072866E-8, 2.75573136213857245213E-6,
+			-1.98412698295895385996E-4, 8.33333333332211858878E-3, -1.66666666666666307295E-1 };
+		const double COS_COEFFICIENTS[] = { -1.13585365213876817300E-11, 2.08757008419747316778E-9, -2.75573141792967388112E-7,
+			2.48015872888517045348E-5, -1.38888888888730564116E-3, 4.16666666666665929218E-2 };
+		const double ASIN_P[] = { 4.253011369004428248960E-3, -6.019598008014123785661E-1, 5.444622390564711410273E0,
+			-1.626247967210700244449E1, 1.956261983317594739197E1, -8.198089802484824371615E0 };
+		const double ASIN_Q[] = { 1.0, -1.474091372988853791896E1, 7.049610280856842141659E1, -1.471791292232726029859E2,
+			1.395105614657485689735E2, -4.918853881490881290097E1 };
+		//pi / 2 split into three parts, so reduced angle is exact
+		const double PIO2_1 = 1.57079625129699707031E0;
+		const double PIO2_2 = 7.54978941586159635335E-8;
+		const double PIO2_3 = 5.39030285815811905290E-15;
+		const double PIO4 = 7.85398163397448309616E-1;
+		const double PIO2_LOW = 6.123233995736765886130E-17; //pi / 2 - double(pi / 2)
+		const double PI = 3.14159265358979323846;
+		//adding and subtracting it rounds double to integer, low bits of sum are the integer
+		const double ROUND_MAGIC = 6755399441055744.0;
+
+		template <typename Double>
+		__attribute__((always_inline)) inline void Polynomial(const Double& x, const double(&coefficients)[6], Double& result) {
+			result = x * coefficients[0] + coefficients[1];
+			for (size_t i = 2; i < 6; ++i) {
+				result = result * x + coefficients[i];
+			};
+		}
+
+		//sqrt is made by SSE2 instruction, which is available in any x86-64 processor
+		__attribute__((always_inline)) inline void Sqrt(const Double2& x, Double2& result) {
+			result = _mm_sqrt_pd(x);
+		}
+
+		//AVX vector is processed by halves, so no AVX instruction is needed outside AVX2 function
+		__attribute__((always_inline)) inline void Sqrt(const Double4& x, Double4& result) {
+			Double2 low, high;
+			Sqrt(Double2{ x[0], x[1] }, low);
+			Sqrt(Double2{ x[2], x[3] }, high);
+			result = Double4{ low[0], low[1], high[0], high[1] };
+		}
+
+		//cos of non negative angle
+		template <typename Double, typename Int>
+		__attribute__((always_inline)) inline void Cos(const Double& x, Double& cos_x) {
+			//x = n * pi / 2 + r, |r| <= pi / 4
+			const Double rounded = x * (2.0 / PI) + ROUND_MAGIC;
+			const Int quadrant = (Int)rounded & 3;
+			const Double n = rounded - ROUND_MAGIC;
+			const Double r = ((x - n * PIO2_1) - n * PIO2_2) - n * PIO2_3;
+			const Double rr = r * r;
+
+			Double sin_polynomial, cos_polynomial;
+			Polynomial(rr, SIN_COEFFICIENTS, sin_polynomial);
+			Polynomial(rr, COS_COEFFICIENTS, cos_polynomial);
+			const Double sin_r = r + r * rr * sin_polynomial;
+			const Double cos_r = 1.0 - rr * 0.5 + rr * rr * cos_polynomial;
+			//cos(r), -sin(r), -cos(r), sin(r) for quadrants 0..3
+			const Double result = (quadrant & 1) != 0 ? sin_r : cos_r;
+			cos_x = ((quadrant + 1) & 2) != 0 ? -result : result;
+		}
+
+		//acos of value in [-1, 1], all cases are reduced to asin of value in [-0.5, 0.5]
+		template <typename Double, typename Int>
+		__attribute__((always_inline)) inline void Acos(const Double& x, Double& acos_x) {
+			const Int is_big = x > 0.5;
+			const Int is_small = x < -0.5;
+			const Double half_rest = (1.0 - (is_small != 0 ? -x : x)) * 0.5;
+			Double root;
+			Sqrt(half_rest, root);
+			const Double a = (is_big | is_small) != 0 ? root : x;
+
+			const Double aa = a * a;
+			Double p, q;
+			Polynomial(aa, ASIN_P, p);
+			Polynomial(aa, ASIN_Q, q);
+			const Double asin = a + a * (aa * p / q);
+
+			const Double middle = ((PIO4 - asin) + PIO2_LOW) + PIO4;
+			const Double big = asin + asin;
+			const Double small = (PI - big) + 2 * PIO2_LOW;
+			acos_x = is_big != 0 ? big : (is_small != 0 ? small : middle);
+		}
+
+		template <typename Double, typename Int>
+		__attribute__((always_inline)) inline void ComputeDistancesVector(const PointsArrays& from, const PointsArrays& to,
+			size_t count, double* distances) {
+			constexpr size_t width = sizeof(Double) / sizeof(double);
+			const auto load = [](const double* values, Double& result) {
+				std::memcpy(&result, values, sizeof(result));
+			};
+			const Double zero{};
+			const Double one = zero + 1.0;
+
+			//computes width distances starting from i-th
+			const auto compute = [&](const PointsArrays& from, const PointsArrays& to, size_t i, double* distances) {
+				Double lat_from, lat_to, lng_from, lng_to, sin_from, sin_to, cos_from, cos_to;
+				load(from.lat + i, lat_from);
+				load(to.lat + i, lat_to);
+				load(from.lng + i, lng_from);
+				load(to.lng + i, lng_to);
+				load(from.sin_lat + i, sin_from);
+				load(to.sin_lat + i, sin_to);
+				load(from.cos_lat + i, cos_from);
+				load(to.cos_lat + i, cos_to);
+
+				const Double lng_difference = lng_from - lng_to;
+				const Double angle = (lng_difference < 0 ? -lng_difference : lng_difference) * dr;
+				Double cos_angle;
+				Cos<Double, Int>(angle, cos_angle);
+				Double cos_distance = sin_from * sin_to + cos_from * cos_to * cos_angle;
+				cos_distance = cos_distance > one ? one : (cos_distance < -one ? -one : cos_distance);
+
+				Double result;
+				Acos<Double, Int>(cos_distance, result);
+				result *= earth_radius;
+				result = ((lat_from == lat_to) & (lng_from == lng_to)) != 0 ? zero : result;
+				std::memcpy(distances + i, &result, sizeof(result));
+			};
+
+			size_t i = 0;
+			for (; i + width <= count; i += width) {
+				compute(from, to, i, distances);
+			};
+
+			//rest is computed by the same code in padded arrays, so every distance doesnt depend on its place in batch
+			if (i < count) {
+				double values[8][width] = {};
+				double rest_distances[width];
+				for (size_t j = 0; i + j < count; ++j) {
+					values[0][j] = from.lat[i + j];
+					values[1][j] = from.lng[i + j];
+					values[2][j] = from.sin_lat[i + j];
+					values[3][j] = from.cos_lat[i + j];
+					values[4][j] = to.lat[i + j];
+					values[5][j] = to.lng[i + j];
+					values[6][j] = to.sin_lat[i + j];
+					values[7][j] = to.cos_lat[i + j];
+				};
+				compute({ values[0], values[1], values[2], values[3] }, { values[4], values[5], values[6], values[7] }, 0, rest_distances);
+				std::memcpy(distances + i, rest_distances, (count - i) * sizeof(double));
+			};
+		}
+
+		__attribute__((target("avx2"))) void ComputeDistancesAvx2(const PointsArrays& from, const PointsArrays& to,
+			size_t count, double* distances) {
+			ComputeDistancesVector<Double4, Int4>(from, to, count, distances);
+		}
+
+		void ComputeDistancesSse2(const PointsArrays& from, const PointsArrays& to, size_t count, double* distances) {
+			ComputeDistancesVector<Double2, Int2>(from, to, count, distances);
+		}
+#endif
+	}
+
+	PreparedCoordinates::PreparedCoordinates(const Coordinates& coordinates) : Coordinates(coordinates),
+		sin_lat(std::sin(coordinates.lat * dr)), cos_lat(std::cos(coordinates.lat * dr)) {
+	}
+
 	double ComputeDistance(Coordinates from, Coordinates to) {
 		//if from point is same as to point then return 0
 		if (from.lat == to.lat && from.lng == to.lng) { return 0; };
 
-		const double dr = 3.1415926535 / 180.0;
-		const double earth_radius = 6371000.0;
 		return std::acos(std::sin(from.lat * dr) * std::sin(to.lat * dr)
 			+ std::cos(from.lat * dr) * std::cos(to.lat * dr) * std::cos(std::abs(from.lng - to.lng) * dr))
 			* earth_radius;
 	}
+
+	double ComputeDistance(const PreparedCoordinates& from, const PreparedCoordinates& to) {
+		if (from.lat == to.lat && from.lng == to.lng) { return 0; };
+
+		//longitude is kept in degrees, so difference is converted as in plain version and result is the same
+		return std::acos(from.sin_lat * to.sin_lat + from.cos_lat * to.cos_lat * std::cos(std::abs(from.lng - to.lng) * dr))
+			* earth_radius;
+	}
+
+	void PointsBuffer::Clear() {
+		lat_.clear();
+		lng_.clear();
+		sin_lat_.clear();
+		cos_lat_.clear();
+	}
+
+	void PointsBuffer::Add(const PreparedCoordinates& point) {
+		lat_.push_back(point.lat);
+		lng_.push_back(point.lng);
+		sin_lat_.push_back(point.sin_lat);
+		cos_lat_.push_back(point.cos_lat);
+	}
+
+	PointsArrays PointsBuffer::Arrays() const {
+		return { lat_.data(), lng_.data(), sin_lat_.data(), cos_lat_.data() };
+	}
+
+	bool IsKernelSupported(DistancesKernel kernel) {
+		switch (kernel) {
+		case DistancesKernel::SCALAR:
+			return true;
+#if defined(__GNUC__) && defined(__x86_64__)
+		case DistancesKernel::SSE2:
+			//SSE2 is always supported by x86-64
+			return true;
+		case DistancesKernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+		default:
+			return false;
+		};
+	}
+
+	DistancesKernel GetBestKernel() {
+		static const DistancesKernel best = IsKernelSupported(DistancesKernel::AVX2) ? DistancesKernel::AVX2
+			: IsKernelSupported(DistancesKernel::SSE2) ? DistancesKernel::SSE2
+			: DistancesKernel::SCALAR;
+		return best;
+	}
+
+	void ComputeDistances(DistancesKernel kernel, const PointsArrays& from, const PointsArrays& to, size_t count, double* distances) {
+		if (!IsKernelSupported(kernel)) {
+			throw std::invalid_argument("Distances kernel is not supported");
+		};
+		switch (kernel) {
+#if defined(__GNUC__) && defined(__x86_64__)
+		case DistancesKernel::AVX2:
+			ComputeDistancesAvx2(from, to, count, distances);
+			break;
+		case DistancesKernel::SSE2:
+			ComputeDistancesSse2(from, to, count, distances);
+			break;
+#endif
+		default:
+			ComputeDistancesScalar(from, to, count, distances);
+			break;
+		};
+	}
+
+	void ComputeDistances(const PointsArrays& from, const PointsArrays& to, size_t count, double* distances) {
+		ComputeDistances(GetBestKernel(), from, to, count, distances);
+	}
 } //end of namespace geo
\ No newline at end of file
@@ -1,4 +1,6 @@
 #pragma once
+#include <cstddef>
+#include <vector>
 
 namespace geo {
 	struct Coordinates {
@@ -6,5 +8,65 @@ namespace geo {
 		double lng;
 	};
 
+	//coordinates with sin and cos of latitude, which are same in every distance to the point
+	struct PreparedCoordinates : Coordinates {
+		PreparedCoordinates() = default;
+
+		explicit PreparedCoordinates(const Coordinates& coordinates);
+
+		double sin_lat{};
+		double cos_lat{};
+	};
+
 	double ComputeDistance(Coordinates from, Coordinates to);
+
+	//same result as for plain coordinates, but only one cos and one acos are computed
+	double ComputeDistance(const PreparedCoordinates& from, const PreparedCoordinates& to);
+
+	//prepared coordinates of several points in separate arrays, i-th point is made of i-th items
+	struct PointsArrays {
+		const double* lat;
+		const double* lng;
+		const double* sin_lat;
+		const double* cos_lat;
+	};
+
+	//owns arrays of points, so points can be collected one by one
+	class PointsBuffer {
+	public:
+		void Clear();
+
+		void Add(const PreparedCoordinates& point);
+
+		PointsArrays Arrays() const;
+
+	private:
+		std::vector<double> lat_{};
+		std::vector<double> lng_{};
+		std::vector<double> sin_lat_{};
+		std::vector<double> cos_lat_{};
+	};
+
+	//scalar kernel is built for every processor, SSE2 and AVX2 ones only for x86-64
+	enum class DistancesKernel {
+		SCALAR, //one distance at once by std::cos and std::acos, same as ComputeDistance
+		SSE2, //two distances at once, cos and acos are approximated by polynomials
+		AVX2, //four distances at once by the same polynomials
+	};
+
+	//kernel is built for this target and processor has its instructions
+	bool IsKernelSupported(DistancesKernel kernel);
+
+	//widest supported kernel, processor is checked once
+	DistancesKernel GetBestKernel();
+
+	//distances[i] is distance from i-th point of from to i-th point of to. every distance d of vector kernels
+	//differs from ComputeDistance by less than 1e-9 * d + 0.02 / d meters, second part comes from acos
+	//of value close to 1, ComputeDistance has error of the same size. cos of angle is clamped to [-1, 1],
+	//so result is never nan. distance between two points is the same wherever they are placed in arrays.
+	//throws std::invalid_argument if kernel is not supported
+	void ComputeDistances(DistancesKernel kernel, const PointsArrays& from, const PointsArrays& to, size_t count, double* distances);
+
+	//computed by best kernel
+	void ComputeDistances(const PointsArrays& from, const PointsArrays& to, size_t count, double* distances);
 }//end of namespace geo
@@ -0,0 +1,157 @@
+#include "input_file.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#endif
+
+namespace io {
+
+	using namespace std::string_literals;
+
+#if defined(__unix__) || defined(__APPLE__)
+	namespace {
+		//closes descriptor when reading is finished, mapping doesnt need it
+		class FileDescriptor {
+		public:
+			explicit FileDescriptor(int fd, bool owned) : fd_(fd), owned_(owned) {
+			}
+
+			FileDescriptor(const FileDescriptor&) = delete;
+
+			FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+			~FileDescriptor() {
+				if (owned_) {
+					close(fd_);
+				};
+			}
+
+			int Get() const {
+				return fd_;
+			}
+
+		private:
+			int fd_;
+			bool owned_;
+		};
+
+		constexpr size_t READ_BLOCK_SIZE = size_t(1) << 20;
+	} //end of anonymous namespace
+
+	InputFile::InputFile(const std::string& path) {
+		const bool is_stdin = path == "-"s;
+		const int fd = is_stdin ? STDIN_FILENO : open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to open "s + path);
+		};
+		const FileDescriptor descriptor(fd, !is_stdin);
+
+		struct stat info {};
+		if (fstat(fd, &info) != 0) {
+			throw std::system_error(errno, std::generic_category(), "Failed to read "s + path);
+		};
+		const bool is_regular = S_ISREG(info.st_mode);
+		const size_t size = is_regular ? static_cast<size_t>(info.st_size) : 0;
+
+		//empty file cant be mapped, file can also be on file system without mapping support
+		if (is_regular && size > 0) {
+			void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (mapping != MAP_FAILED) {
+				//parser reads input once from begin to end, so kernel can read ahead and drop read pages
+				madvise(mapping, size, MADV_SEQUENTIAL);
+				mapping_ = mapping;
+				mapping_size_ = size;
+				data_ = std::string_view(static_cast<const char*>(mapping), size);
+				return;
+			};
+		};
+		ReadAll(fd, size);
+	}
+
+	void InputFile::ReadAll(int fd, size_t size) {
+		//buffer grows by big blocks, so pipe is read by few calls without intermediate copies
+		buffer_.resize(std::max(size, READ_BLOCK_SIZE));
+		size_t done = 0;
+		while (true) {
+			if (done == buffer_.size()) {
+				buffer_.resize(buffer_.size() * 2);
+			};
+			const ssize_t count = read(fd, buffer_.data() + done, buffer_.size() - done);
+			if (count < 0) {
+				if (errno == EINTR) {
+					continue;
+				};
+				throw std::system_error(errno, std::generic_category(), "Failed to read input"s);
+			};
+			if (count == 0) {
+				break;
+			};
+			done += static_cast<size_t>(count);
+		};
+		buffer_.resize(done);
+		data_ = buffer_;
+	}
+
+	void InputFile::Release() {
+		if (mapping_ != nullptr) {
+			munmap(mapping_, mapping_size_);
+			mapping_ = nullptr;
+			mapping_size_ = 0;
+		};
+		std::string().swap(buffer_);
+		data_ = {};
+	}
+#else
+	//without POSIX mapping whole file is read by stream
+	InputFile::InputFile(const std::string& path) {
+		if (path == "-"s) {
+			ReadAll(0, 0);
+			return;
+		};
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			throw std::system_error(ENOENT, std::generic_category(), "Failed to open "s + path);
+		};
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		buffer_ = stream.str();
+		data_ = buffer_;
+	}
+
+	void InputFile::ReadAll(int, size_t) {
+		std::ostringstream stream;
+		stream << std::cin.rdbuf();
+		buffer_ = stream.str();
+		data_ = buffer_;
+	}
+
+	void InputFile::Release() {
+		std::string().swap(buffer_);
+		data_ = {};
+	}
+#endif
+
+	InputFile::~InputFile() {
+		Release();
+	}
+
+	std::string_view InputFile::GetData() const {
+		return data_;
+	}
+
+	bool InputFile::IsMapped() const {
+		return mapping_ != nullptr;
+	}
+
+}//end of namespace io
\ No newline at end of file
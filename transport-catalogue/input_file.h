@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace io {
+
+	//whole input as one contiguous buffer: regular file is mapped to memory, pipes and other files
+	//which cant be mapped are read to one buffer. path "-" means standard input
+	class InputFile {
+	public:
+		explicit InputFile(const std::string& path);
+
+		InputFile(const InputFile&) = delete;
+
+		InputFile& operator=(const InputFile&) = delete;
+
+		~InputFile();
+
+		//valid until Release
+		std::string_view GetData() const;
+
+		//unmaps file or frees buffer, data must not be used after it
+		void Release();
+
+		bool IsMapped() const;
+
+	private:
+		void* mapping_ = nullptr;
+		size_t mapping_size_ = 0;
+		std::string buffer_{};
+		std::string_view data_{};
+
+		//size is used as capacity of first read if it is known
+		void ReadAll(int fd, size_t size);
+	};
+
+}//end of namespace io
\ No newline at end of file
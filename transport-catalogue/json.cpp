@@ -1,10 +1,105 @@
 #include "json.h"
+#include "json_index.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cctype>
+#include <cstring>
+#include <iterator>
 
 namespace json {
 
 	using namespace std::string_literals;
 	using namespace std::string_view_literals;
 
+	Dict::Dict(std::pmr::memory_resource* resource) : items_(resource) {
+	}
+
+	Dict::Dict(std::pmr::vector<value_type> items) : items_(std::move(items)) {
+		//objects usually have only a few keys, insertion sort does not need a buffer for them
+		if (items_.size() <= 16) {
+			for (size_t i = 1; i < items_.size(); ++i) {
+				for (size_t j = i; j > 0 && items_[j].first < items_[j - 1].first; --j) {
+					std::swap(items_[j], items_[j - 1]);
+				};
+			};
+		}
+		else {
+			std::stable_sort(items_.begin(), items_.end(), [](const value_type& lhs, const value_type& rhs) {
+				return lhs.first < rhs.first;
+				});
+		};
+		//removing duplicated keys, keeping last of them as map operator[] does
+		auto last = items_.begin();
+		for (auto it = items_.begin(); it != items_.end(); ++it) {
+			if (it + 1 != items_.end() && it->first == (it + 1)->first) {
+				continue;
+			};
+			if (last != it) {
+				*last = std::move(*it);
+			};
+			++last;
+		};
+		items_.erase(last, items_.end());
+	}
+
+	Node& Dict::operator[](Key key) {
+		const auto position = items_.begin() + (LowerBound(key.AsStringView()) - items_.cbegin());
+		if (position != items_.end() && position->first == key) {
+			return position->second;
+		};
+		return items_.emplace(position, std::move(key), nullptr)->second;
+	}
+
+	const Node& Dict::at(std::string_view key) const {
+		const auto it = find(key);
+		if (it == items_.end()) {
+			throw std::out_of_range("Key is not found: "s + std::string(key));
+		};
+		return it->second;
+	}
+
+	Dict::const_iterator Dict::find(std::string_view key) const {
+		//for small objects linear search is faster than binary one
+		if (items_.size() <= 8) {
+			return std::find_if(items_.begin(), items_.end(), [key](const value_type& item) {
+				return item.first.AsStringView() == key;
+				});
+		};
+		const auto it = LowerBound(key);
+		return (it != items_.end() && it->first.AsStringView() == key) ? it : items_.end();
+	}
+
+	size_t Dict::count(std::string_view key) const {
+		return find(key) == items_.end() ? 0 : 1;
+	}
+
+	Dict::const_iterator Dict::begin() const {
+		return items_.begin();
+	}
+
+	Dict::const_iterator Dict::end() const {
+		return items_.end();
+	}
+
+	size_t Dict::size() const {
+		return items_.size();
+	}
+
+	bool Dict::empty() const {
+		return items_.empty();
+	}
+
+	bool Dict::operator==(const Dict& other) const {
+		return items_ == other.items_;
+	}
+
+	Dict::const_iterator Dict::LowerBound(std::string_view key) const {
+		return std::lower_bound(items_.begin(), items_.end(), key, [](const value_type& item, std::string_view key) {
+			return item.first.AsStringView() < key;
+			});
+	}
+
 	Node LoadNumber(std::istream& input) {
 
 		std::string parsed_num;
@@ -167,7 +262,7 @@ namespace json {
 			throw ParsingError("Failed to parse map node"s);
 		};
 
-		return Node(move(result));
+		return Node(std::move(result));
 	}
 
 	Node LoadBoolOrPtrCommand(std::istream& input) {
@@ -223,80 +318,827 @@ namespace json {
 		}
 	}
 
-	void PrintJson(const Node& node, std::ostream& output) {
-		if (node.IsArray()) {
-			bool first = true;
-			output << '[' << std::endl;
-			for (const auto& obj : node.AsArray()) {
-				if (first) {
-					PrintJson(obj, output);
-					first = false;
+	namespace {
+
+		//parser over contiguous buffer driven by structural index: parser jumps from one indexed char to another,
+		//so whitespaces are not visited and chars of strings are visited only if string has escapes
+		class BufferParser {
+		public:
+			//in views mode strings and keys without escapes refer to input instead of copying it
+			BufferParser(std::string_view input, bool views, std::pmr::memory_resource* resource)
+				: begin_(input.data()), pos_(input.data()), end_(input.data() + input.size()), views_(views),
+				resource_(resource), indexer_(input) {
+			}
+
+			Node ParseValue() {
+				switch (NextChar()) {
+				case '[': Skip(); return ParseArray();
+				case '{': Skip(); return ParseDict();
+				case '"': Skip(); return ParseStringNode();
+				case 't': return ParseLiteral("true"sv, Node{ true });
+				case 'f': return ParseLiteral("false"sv, Node{ false });
+				case 'n': return ParseLiteral("null"sv, Node{ nullptr });
+				case ']': case '}': throw ParsingError("Wrong format of array or map"s);
+				default: return ParseNumber();
+				}
+			}
+
+			//same grammar as ParseValue, parts of value are passed to handler instead of building nodes
+			void ParseEvents(SaxHandler& handler) {
+				switch (NextChar()) {
+				case '[': Skip(); ParseArrayEvents(handler); break;
+				case '{': Skip(); ParseDictEvents(handler); break;
+				case '"': {
+					Skip();
+					std::string_view view;
+					if (TryParsePlainString(view)) {
+						handler.Value(view);
+					}
+					else {
+						const std::string line = ParseString();
+						handler.Value(std::string_view(line));
+					};
+					break;
+				}
+				case 't': ParseLiteral("true"sv, Node{ true }); handler.Value(true); break;
+				case 'f': ParseLiteral("false"sv, Node{ false }); handler.Value(false); break;
+				case 'n': ParseLiteral("null"sv, Node{ nullptr }); handler.Value(nullptr); break;
+				case ']': case '}': throw ParsingError("Wrong format of array or map"s);
+				default: {
+					const Node number = ParseNumber();
+					if (number.IsInt()) {
+						handler.Value(number.AsInt());
+					}
+					else {
+						handler.Value(number.AsDouble());
+					};
+				}
+				}
+			}
+
+			//values separated by commas as in array, input without values is allowed
+			void ParseItemsEvents(SaxHandler& handler) {
+				if (!HasToken()) {
+					return;
+				};
+				while (true) {
+					ParseEvents(handler);
+					if (!HasToken()) {
+						break;
+					};
+					if (NextChar() != ',') {
+						throw ParsingError("Failed to parse array node"s);
+					};
+					Skip();
+				};
+			}
+
+		private:
+			const char* begin_;
+			const char* pos_;
+			const char* end_;
+			const bool views_;
+			std::pmr::memory_resource* resource_;
+			StructuralIndexer indexer_;
+			//items of arrays and dicts which are parsed now, nested containers put their items above items
+			//of outer ones. container takes its items at once, so vectors in arena are not grown and dont
+			//leave their old buffers in it
+			std::vector<Node> array_items_{};
+			std::vector<Dict::value_type> dict_items_{};
+			const size_t* tokens_ = nullptr; //positions of indexed chars of current part of input
+			size_t tokens_count_ = 0;
+			size_t token_ = 0; //next indexed char which is not consumed yet
+
+			//index of next part of input is built when its tokens are needed
+			bool HasToken() {
+				while (token_ == tokens_count_) {
+					if (indexer_.IsFinished()) {
+						return false;
+					};
+					tokens_count_ = indexer_.IndexNext();
+					tokens_ = indexer_.Positions();
+					token_ = 0;
+				};
+				return true;
+			}
+
+			//moves to next indexed char and returns it without consuming
+			char NextChar() {
+				if (!HasToken()) {
+					throw ParsingError("Unexpected end of input"s);
+				};
+				pos_ = begin_ + tokens_[token_];
+				return *pos_;
+			}
+
+			//consumes structural char or quote returned by NextChar
+			void Skip() {
+				++pos_;
+				++token_;
+			}
+
+			//consumes number or literal, it has to end where index expects, otherwise its tail would be skipped
+			void SkipScalar() {
+				if (pos_ != end_ && *pos_ != ' ' && *pos_ != '\n' && *pos_ != '\r' && *pos_ != '\t'
+					&& *pos_ != ',' && *pos_ != ']' && *pos_ != '}' && *pos_ != ':' && *pos_ != '[' && *pos_ != '{') {
+					throw ParsingError("Unexpected char after value: "s + *pos_);
+				};
+				++token_;
+			}
+
+			//opening quote is consumed, so closing one is the next indexed char
+			const char* StringEnd() {
+				if (!HasToken()) {
+					throw ParsingError("Failed to parse string node"s);
+				};
+				return begin_ + tokens_[token_];
+			}
+
+			//index is built at least up to string end, so string cant have escapes if last backslash is before it
+			bool HasEscapes(const char* string_end) const {
+				return indexer_.BackslashesEnd() > static_cast<size_t>(pos_ - begin_)
+					&& std::memchr(pos_, '\\', static_cast<size_t>(string_end - pos_)) != nullptr;
+			}
+
+			Node ParseArray() {
+				Array result(resource_);
+				if (NextChar() == ']') {
+					Skip();
+					return Node(std::move(result));
+				};
+				const size_t first = array_items_.size();
+				while (true) {
+					array_items_.push_back(ParseValue());
+					const char c = NextChar();
+					Skip();
+					if (c == ']') {
+						break;
+					}
+					else if (c != ',') {
+						throw ParsingError("Failed to parse array node"s);
+					};
+				};
+				result.reserve(array_items_.size() - first);
+				std::move(array_items_.begin() + first, array_items_.end(), std::back_inserter(result));
+				array_items_.resize(first);
+				return Node(std::move(result));
+			}
+
+			Node ParseDict() {
+				std::pmr::vector<Dict::value_type> items(resource_);
+				if (NextChar() == '}') {
+					Skip();
+					return Node(Dict(std::move(items)));
+				};
+				const size_t first = dict_items_.size();
+				while (true) {
+					if (NextChar() != '"') {
+						throw ParsingError("Failed to parse map key"s);
+					};
+					Skip();
+					std::string_view key_view;
+					Key key = TryParsePlainString(key_view) ? Key::FromView(key_view) : Key(ParseString());
+					if (NextChar() != ':') {
+						throw ParsingError("Failed to parse map node"s);
+					};
+					Skip();
+					dict_items_.emplace_back(std::move(key), ParseValue());
+					const char c = NextChar();
+					Skip();
+					if (c == '}') {
+						break;
+					}
+					else if (c != ',') {
+						throw ParsingError("Failed to parse map node"s);
+					};
+				};
+				items.reserve(dict_items_.size() - first);
+				std::move(dict_items_.begin() + first, dict_items_.end(), std::back_inserter(items));
+				dict_items_.resize(first);
+				return Node(Dict(std::move(items)));
+			}
+
+			void ParseArrayEvents(SaxHandler& handler) {
+				handler.StartArray();
+				if (NextChar() == ']') {
+					Skip();
+					handler.EndArray();
+					return;
+				};
+				while (true) {
+					ParseEvents(handler);
+					const char c = NextChar();
+					Skip();
+					if (c == ']') {
+						break;
+					}
+					else if (c != ',') {
+						throw ParsingError("Failed to parse array node"s);
+					};
+				};
+				handler.EndArray();
+			}
+
+			void ParseDictEvents(SaxHandler& handler) {
+				handler.StartDict();
+				if (NextChar() == '}') {
+					Skip();
+					handler.EndDict();
+					return;
+				};
+				while (true) {
+					if (NextChar() != '"') {
+						throw ParsingError("Failed to parse map key"s);
+					};
+					Skip();
+					std::string_view key_view;
+					if (TryParsePlainString(key_view)) {
+						handler.Key(key_view);
+					}
+					else {
+						const std::string key = ParseString();
+						handler.Key(key);
+					};
+					if (NextChar() != ':') {
+						throw ParsingError("Failed to parse map node"s);
+					};
+					Skip();
+					ParseEvents(handler);
+					const char c = NextChar();
+					Skip();
+					if (c == '}') {
+						break;
+					}
+					else if (c != ',') {
+						throw ParsingError("Failed to parse map node"s);
+					};
+				};
+				handler.EndDict();
+			}
+
+			Node ParseStringNode() {
+				std::string_view view;
+				if (TryParsePlainString(view)) {
+					return Node(view);
+				};
+				return Node(ParseString());
+			}
+
+			//in views mode takes string as view if it has no escapes, otherwise keeps position
+			bool TryParsePlainString(std::string_view& view) {
+				if (!views_) {
+					return false;
+				};
+				const char* string_end = StringEnd();
+				if (HasEscapes(string_end)) {
+					return false;
+				};
+				view = std::string_view(pos_, static_cast<size_t>(string_end - pos_));
+				pos_ = string_end;
+				Skip();
+				return true;
+			}
+
+			//opening quote is already consumed, runs of chars without escapes are copied at once
+			std::string ParseString() {
+				const char* string_end = StringEnd();
+				std::string line;
+				if (!HasEscapes(string_end)) {
+					line.assign(pos_, string_end);
+					pos_ = string_end;
+					Skip();
+					return line;
+				};
+				while (true) {
+					const char* run_end = static_cast<const char*>(std::memchr(pos_, '\\', static_cast<size_t>(string_end - pos_)));
+					if (run_end == nullptr) {
+						line.append(pos_, string_end);
+						pos_ = string_end;
+						Skip();
+						return line;
+					};
+					line.append(pos_, run_end);
+					pos_ = run_end + 1;
+					AppendEscaped(line);
+				};
+			}
+
+			void AppendEscaped(std::string& line) {
+				if (pos_ == end_) {
+					throw ParsingError("Failed to parse string node"s);
+				};
+				switch (*pos_++) {
+				case '"': line += '"'; break;
+				case '\\': line += '\\'; break;
+				case '/': line += '/'; break;
+				case 'b': line += '\b'; break;
+				case 'f': line += '\f'; break;
+				case 'n': line += '\n'; break;
+				case 'r': line += '\r'; break;
+				case 't': line += '\t'; break;
+				case 'u': AppendCodePoint(line); break;
+				default: throw ParsingError("Unknown escape sequence"s);
+				}
+			}
+
+			//converting \uXXXX escape (with surrogate pairs) to utf-8, high surrogate must be followed by low one
+			void AppendCodePoint(std::string& line) {
+				uint32_t code = ParseHex4();
+				if (code >= 0xDC00 && code <= 0xDFFF) {
+					throw ParsingError("Unpaired low surrogate in unicode escape sequence"s);
+				};
+				if (code >= 0xD800 && code <= 0xDBFF) {
+					if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u') {
+						throw ParsingError("Unpaired high surrogate in unicode escape sequence"s);
+					};
+					pos_ += 2;
+					const uint32_t low = ParseHex4();
+					if (low < 0xDC00 || low > 0xDFFF) {
+						throw ParsingError("High surrogate is not followed by low one in unicode escape sequence"s);
+					};
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				};
+				if (code < 0x80) {
+					line += static_cast<char>(code);
+				}
+				else if (code < 0x800) {
+					line += static_cast<char>(0xC0 | (code >> 6));
+					line += static_cast<char>(0x80 | (code & 0x3F));
+				}
+				else if (code < 0x10000) {
+					line += static_cast<char>(0xE0 | (code >> 12));
+					line += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					line += static_cast<char>(0x80 | (code & 0x3F));
 				}
 				else {
-					output << ", "sv << std::endl;
-					PrintJson(obj, output);
+					line += static_cast<char>(0xF0 | (code >> 18));
+					line += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					line += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					line += static_cast<char>(0x80 | (code & 0x3F));
 				};
 			}
-			output << std::endl << ']';
-		}
-		else if (node.IsDict()) {
-			bool first = true;
-			output << '{' << std::endl;
-			for (const auto& [key, node_] : node.AsDict()) {
-				if (first) {
-					output << '\"' << key << "\": "sv;
-					PrintJson(node_, output);
-					first = false;
+
+			uint32_t ParseHex4() {
+				uint32_t code{};
+				if (end_ - pos_ < 4 || std::from_chars(pos_, pos_ + 4, code, 16).ptr != pos_ + 4) {
+					throw ParsingError("Wrong unicode escape sequence"s);
+				};
+				pos_ += 4;
+				return code;
+			}
+
+			Node ParseLiteral(std::string_view literal, Node value) {
+				if (static_cast<size_t>(end_ - pos_) < literal.size() || std::string_view(pos_, literal.size()) != literal) {
+					throw ParsingError("Wrong command: "s + std::string(pos_, std::min<size_t>(end_ - pos_, literal.size())));
+				};
+				pos_ += literal.size();
+				SkipScalar();
+				return value;
+			}
+
+			//checks number grammar first, then converts it with from_chars
+			Node ParseNumber() {
+				const char* start = pos_;
+				auto skip_digits = [this] {
+					if (pos_ == end_ || !std::isdigit(static_cast<unsigned char>(*pos_))) {
+						throw ParsingError("A digit is expected"s);
+					};
+					while (pos_ != end_ && std::isdigit(static_cast<unsigned char>(*pos_))) {
+						++pos_;
+					};
+				};
+
+				if (*pos_ == '-') {
+					++pos_;
+				};
+				if (pos_ != end_ && *pos_ == '0') {
+					++pos_;
 				}
 				else {
-					output << ", "sv << std::endl;
-					output << '\"' << key << "\": "sv;
-					PrintJson(node_, output);
+					skip_digits();
+				};
+
+				bool is_int = true;
+				if (pos_ != end_ && *pos_ == '.') {
+					++pos_;
+					skip_digits();
+					is_int = false;
+				};
+				if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+					++pos_;
+					if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) {
+						++pos_;
+					};
+					skip_digits();
+					is_int = false;
+				};
+				SkipScalar();
+
+				if (is_int) {
+					int value{};
+					//in case of overflow number will be parsed as double
+					if (std::from_chars(start, pos_, value).ec == std::errc{}) {
+						return Node(value);
+					};
 				};
+				double value{};
+				if (std::from_chars(start, pos_, value).ec != std::errc{}) {
+					throw ParsingError("Failed to convert "s + std::string(start, pos_) + " to number"s);
+				};
+				return Node(value);
 			}
-			output << std::endl << '}';
+		};
+
+		//arrays and dicts of parsed feeds take from 2.5 to 3.5 bytes for every byte of input, so arena of that size
+		//usually gets only one chunk instead of growing ones. unused tail of chunk is never touched, so it stays virtual
+		size_t ArenaInitialSize(std::string_view input) {
+			return std::max<size_t>(input.size() / 2 * 7, 1024);
 		}
-		else if (node.IsInt()) {
-			output << node.AsInt();
+	} //end of anonymous namespace
+
+	Node LoadNode(std::string_view input, std::pmr::memory_resource* resource) {
+		return BufferParser(input, false, resource).ParseValue();
+	}
+
+	void ParseSax(std::string_view input, SaxHandler& handler) {
+		//strings without escapes are passed as views to input, nodes are not created, so resource is not used
+		BufferParser(input, true, std::pmr::null_memory_resource()).ParseEvents(handler);
+	}
+
+	void ParseSaxItems(std::string_view input, SaxHandler& handler) {
+		BufferParser(input, true, std::pmr::null_memory_resource()).ParseItemsEvents(handler);
+	}
+
+	std::vector<RootValue> SplitRootDict(std::string_view input) {
+		//what is expected at depth of root dict
+		enum class Expected { ROOT, KEY, COLON, VALUE, VALUE_END, NOTHING };
+
+		std::vector<RootValue> result;
+		StructuralIndexer indexer(input);
+		Expected expected = Expected::ROOT;
+		std::vector<char> opened; //brackets of arrays and dicts which are not closed yet
+		bool in_string = false; //quotes are indexed in pairs, so quote closes string if it is opened
+		size_t string_begin = 0;
+		size_t value_begin = 0;
+		size_t item_begin = 0;
+		bool array_value = false;
+		bool item_expected = false;
+
+		while (expected != Expected::NOTHING && !indexer.IsFinished()) {
+			const size_t count = indexer.IndexNext();
+			const size_t* positions = indexer.Positions();
+			for (size_t i = 0; i < count && expected != Expected::NOTHING; ++i) {
+				const size_t pos = positions[i];
+				const char c = input[pos];
+				if (in_string) {
+					in_string = false;
+					if (opened.size() == 1 && expected == Expected::COLON) {
+						result.push_back({ input.substr(string_begin, pos - string_begin), {}, {} });
+					};
+					continue;
+				};
+				if (c == '"') {
+					in_string = true;
+					string_begin = pos + 1;
+				};
+
+				if (opened.empty()) {
+					if (c != '{') {
+						throw ParsingError("Root is not a dict"s);
+					};
+					opened.push_back(c);
+					expected = Expected::KEY;
+					continue;
+				}
+				else if (opened.size() == 1) {
+					switch (expected) {
+					case Expected::KEY:
+						if (c == '}' && result.empty()) {
+							expected = Expected::NOTHING;
+						}
+						else if (c != '"') {
+							throw ParsingError("Failed to parse map key"s);
+						}
+						else {
+							expected = Expected::COLON;
+						};
+						continue;
+					case Expected::COLON:
+						if (c != ':') {
+							throw ParsingError("Failed to parse map node"s);
+						};
+						expected = Expected::VALUE;
+						continue;
+					case Expected::VALUE:
+						if (c == ',' || c == ':' || c == ']' || c == '}') {
+							throw ParsingError("Failed to parse map node"s);
+						};
+						value_begin = pos;
+						array_value = c == '[';
+						item_expected = array_value;
+						expected = Expected::VALUE_END;
+						break;
+					default:
+						if (c != ',' && c != '}') {
+							throw ParsingError("Failed to parse map node"s);
+						};
+						result.back().value = input.substr(value_begin, pos - value_begin);
+						expected = c == ',' ? Expected::KEY : Expected::NOTHING;
+						continue;
+					}
+				}
+				else if (opened.size() == 2 && array_value) {
+					if (item_expected) {
+						const bool empty_array = c == ']' && result.back().items.empty();
+						if (!empty_array && (c == ',' || c == ':' || c == ']' || c == '}')) {
+							throw ParsingError("Failed to parse array node"s);
+						};
+						item_begin = pos;
+						item_expected = false;
+					}
+					else if (c == ',' || c == ']') {
+						result.back().items.push_back(input.substr(item_begin, pos - item_begin));
+						item_expected = c == ',';
+					};
+				};
+
+				if (c == '[' || c == '{') {
+					opened.push_back(c);
+				}
+				else if (c == ']' || c == '}') {
+					if (opened.back() != (c == ']' ? '[' : '{')) {
+						throw ParsingError("Wrong format of array or map"s);
+					};
+					opened.pop_back();
+				};
+			};
+		};
+		if (expected != Expected::NOTHING) {
+			throw ParsingError("Unexpected end of input"s);
+		};
+		return result;
+	}
+
+	void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+		void* ptr = upstream_->allocate(bytes, alignment);
+		++allocations_count_;
+		allocated_bytes_ += bytes;
+		bytes_in_use_ += bytes;
+		peak_bytes_ = std::max(peak_bytes_, bytes_in_use_);
+		return ptr;
+	}
+
+	void CountingResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+		upstream_->deallocate(ptr, bytes, alignment);
+		bytes_in_use_ -= bytes;
+	}
+
+	bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+		return this == &other;
+	}
+
+	Document::Document(std::unique_ptr<const std::string> buffer, std::string_view input)
+		: arena_(ArenaInitialSize(input), &heap_), nodes_(&arena_), buffer_(std::move(buffer)), root_(BufferParser(input, true, &nodes_).ParseValue()) {
+	}
+
+	Document Document::Own(std::string input) {
+		auto buffer = std::make_unique<const std::string>(std::move(input));
+		const std::string_view input_view = *buffer;
+		return Document(std::move(buffer), input_view);
+	}
+
+	Document Document::Borrow(std::string_view input) {
+		return Document(nullptr, input);
+	}
+
+	const Node& Document::GetRoot() const {
+		return root_;
+	}
+
+	Document::MemoryStats Document::GetMemoryStats() const {
+		MemoryStats stats;
+		stats.nodes_allocations = nodes_.GetAllocationsCount();
+		stats.nodes_bytes = nodes_.GetAllocatedBytes();
+		stats.heap_allocations = heap_.GetAllocationsCount();
+		stats.heap_peak_bytes = heap_.GetPeakBytes();
+		return stats;
+	}
+
+	std::string ReadAll(std::istream& input) {
+		std::string buffer;
+		char chunk[1 << 16];
+		while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+			buffer.append(chunk, static_cast<size_t>(input.gcount()));
+		};
+		return buffer;
+	}
+
+	Writer::Writer(std::ostream& output, PrintMode mode) : output_(output), mode_(mode) {
+		buffer_.reserve(BUFFER_SIZE);
+	}
+
+	Writer::~Writer() {
+		Flush();
+	}
+
+	Writer& Writer::StartArray() {
+		BeforeValue();
+		Append(mode_ == PrintMode::PRETTY ? "[\n"sv : "["sv);
+		first_item_.push_back(true);
+		return *this;
+	}
+
+	Writer& Writer::EndArray() {
+		first_item_.pop_back();
+		Append(mode_ == PrintMode::PRETTY ? "\n]"sv : "]"sv);
+		return *this;
+	}
+
+	Writer& Writer::StartDict() {
+		BeforeValue();
+		Append(mode_ == PrintMode::PRETTY ? "{\n"sv : "{"sv);
+		first_item_.push_back(true);
+		return *this;
+	}
+
+	Writer& Writer::EndDict() {
+		first_item_.pop_back();
+		Append(mode_ == PrintMode::PRETTY ? "\n}"sv : "}"sv);
+		return *this;
+	}
+
+	Writer& Writer::Key(std::string_view key) {
+		WriteSeparator();
+		Append('"');
+		AppendEscaped(key);
+		Append(mode_ == PrintMode::PRETTY ? "\": "sv : "\":"sv);
+		after_key_ = true;
+		return *this;
+	}
+
+	Writer& Writer::Value(std::nullptr_t) {
+		BeforeValue();
+		Append("null"sv);
+		return *this;
+	}
+
+	Writer& Writer::Value(bool value) {
+		BeforeValue();
+		Append(value ? "true"sv : "false"sv);
+		return *this;
+	}
+
+	Writer& Writer::Value(int value) {
+		BeforeValue();
+		char number[16];
+		const auto result = std::to_chars(number, number + sizeof(number), value);
+		Append(std::string_view(number, static_cast<size_t>(result.ptr - number)));
+		return *this;
+	}
+
+	Writer& Writer::Value(double value) {
+		BeforeValue();
+		//same format as default ostream output of double: 6 significant digits
+		char number[32];
+		const auto result = std::to_chars(number, number + sizeof(number), value, std::chars_format::general, 6);
+		Append(std::string_view(number, static_cast<size_t>(result.ptr - number)));
+		return *this;
+	}
+
+	Writer& Writer::Value(std::string_view value) {
+		BeforeValue();
+		Append('"');
+		AppendEscaped(value);
+		Append('"');
+		return *this;
+	}
+
+	Writer& Writer::Value(const char* value) {
+		return Value(std::string_view(value));
+	}
+
+	Writer& Writer::Value(const std::string& value) {
+		return Value(std::string_view(value));
+	}
+
+	Writer& Writer::Value(const Node& node) {
+		if (node.IsArray()) {
+			StartArray();
+			for (const auto& item : node.AsArray()) {
+				Value(item);
+			};
+			EndArray();
 		}
-		else if (node.IsDouble()) {
-			output << node.AsDouble();
+		else if (node.IsDict()) {
+			StartDict();
+			for (const auto& [key, item] : node.AsDict()) {
+				Key(key.AsStringView());
+				Value(item);
+			};
+			EndDict();
+		}
+		else if (node.IsInt()) {
+			Value(node.AsInt());
 		}
 		else if (node.IsPureDouble()) {
-			output << node.AsDouble();
+			Value(node.AsDouble());
 		}
 		else if (node.IsBool()) {
-			if (node.AsBool()) {
-				output << "true"sv;
-			}
-			else {
-				output << "false"sv;
-			};
+			Value(node.AsBool());
 		}
-		else if (node.IsString() || node.IsStringView()) {
-			output << '\"';
-			const std::string_view text = node.IsString() ? node.AsString() : node.AsStringView();
-			for (const char c : text) {
-				if (c == '\\') {
-					output << "\\\\"sv;
-				}
-				else if (c == '\"') {
-					output << "\\\""sv;
-				}
-				else if (c == '\n') {
-					output << "\\n"sv;
-				}
-				else if (c == '\r') {
-					output << "\\r"sv;
-				}
-				else {
-					output << c;
-				};
-			};
-			output << '\"';
+		else if (node.IsText()) {
+			Value(node.AsText());
 		}
 		else if (node.IsNull()) {
-			output << "null"sv;
+			Value(nullptr);
+		};
+		return *this;
+	}
+
+	Writer& Writer::RawValue(std::string_view text) {
+		BeforeValue();
+		Append(text);
+		return *this;
+	}
+
+	Writer& Writer::Raw(std::string_view text) {
+		Append(text);
+		return *this;
+	}
+
+	size_t Writer::Position() const {
+		return flushed_ + buffer_.size();
+	}
+
+	void Writer::Flush() {
+		output_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+		flushed_ += buffer_.size();
+		buffer_.clear();
+	}
+
+	void Writer::BeforeValue() {
+		//value after key is already separated from previous dict entry
+		if (after_key_) {
+			after_key_ = false;
+		}
+		else {
+			WriteSeparator();
+		};
+	}
+
+	void Writer::WriteSeparator() {
+		if (first_item_.empty()) {
+			return;
+		};
+		if (first_item_.back()) {
+			first_item_.back() = false;
+		}
+		else {
+			Append(mode_ == PrintMode::PRETTY ? ", \n"sv : ","sv);
 		};
 	}
+
+	void Writer::Append(std::string_view text) {
+		if (buffer_.size() + text.size() > BUFFER_SIZE) {
+			Flush();
+		};
+		//big blocks are passed to stream without copying to buffer
+		if (text.size() >= BUFFER_SIZE) {
+			output_.write(text.data(), static_cast<std::streamsize>(text.size()));
+			flushed_ += text.size();
+		}
+		else {
+			buffer_.append(text);
+		};
+	}
+
+	void Writer::Append(char c) {
+		if (buffer_.size() == BUFFER_SIZE) {
+			Flush();
+		};
+		buffer_.push_back(c);
+	}
+
+	void Writer::AppendEscaped(std::string_view text) {
+		//copying runs of chars without escapes at once
+		size_t run_start = 0;
+		for (size_t i = 0; i < text.size(); ++i) {
+			std::string_view escaped;
+			switch (text[i]) {
+			case '\\': escaped = "\\\\"sv; break;
+			case '"': escaped = "\\\""sv; break;
+			case '\n': escaped = "\\n"sv; break;
+			case '\r': escaped = "\\r"sv; break;
+			default: continue;
+			}
+			Append(text.substr(run_start, i - run_start));
+			Append(escaped);
+			run_start = i + 1;
+		};
+		Append(text.substr(run_start));
+	}
+
+	void PrintJson(const Node& node, std::ostream& output, PrintMode mode) {
+		Writer(output, mode).Value(node);
+	}
 }  // namespace json
\ No newline at end of file
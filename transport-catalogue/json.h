@@ -2,6 +2,8 @@
 
 #include <iostream>
 #include <map>
+#include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <variant>
@@ -12,8 +14,134 @@
 namespace json {
 
 	class Node;
-	using Dict = std::map<std::string, Node>;
-	using Array = std::vector<Node>;
+
+	//dict key, owns its chars or refers to chars of parsed document buffer
+	class Key {
+	public:
+		Key() = default;
+
+		Key(std::string key) : owned_(std::make_unique<const std::string>(std::move(key))), view_(*owned_) {
+		}
+
+		Key(const char* key) : Key(std::string(key)) {
+		}
+
+		Key(const Key& other) : view_(other.view_) {
+			if (other.owned_) {
+				owned_ = std::make_unique<const std::string>(*other.owned_);
+				view_ = *owned_;
+			}
+		}
+
+		Key(Key&&) = default;
+
+		Key& operator=(const Key& other) {
+			if (this != &other) {
+				*this = Key(other);
+			}
+			return *this;
+		}
+
+		Key& operator=(Key&&) = default;
+
+		//chars must outlive key
+		static Key FromView(std::string_view key) {
+			Key result;
+			result.view_ = key;
+			return result;
+		}
+
+		std::string_view AsStringView() const {
+			return view_;
+		}
+
+		bool operator<(const Key& rhs) const {
+			return view_ < rhs.view_;
+		}
+
+		bool operator==(const Key& rhs) const {
+			return view_ == rhs.view_;
+		}
+
+	private:
+		//owned string is kept on heap, so view to it stays valid when key is moved
+		std::unique_ptr<const std::string> owned_{};
+		std::string_view view_{};
+	};
+
+	using Array = std::pmr::vector<Node>;
+
+	//dict as vector of key-value pairs sorted by keys, most of parsed objects have only a few keys,
+	//so search in small contiguous array is faster than walking nodes of a tree
+	class Dict {
+	public:
+		using value_type = std::pair<Key, Node>;
+		using iterator = std::pmr::vector<value_type>::iterator;
+		using const_iterator = std::pmr::vector<value_type>::const_iterator;
+
+		Dict() = default;
+
+		explicit Dict(std::pmr::memory_resource* resource);
+
+		//items can be in any order, for same keys last item is kept
+		explicit Dict(std::pmr::vector<value_type> items);
+
+		Node& operator[](Key key);
+
+		const Node& at(std::string_view key) const;
+
+		const_iterator find(std::string_view key) const;
+
+		size_t count(std::string_view key) const;
+
+		const_iterator begin() const;
+
+		const_iterator end() const;
+
+		size_t size() const;
+
+		bool empty() const;
+
+		bool operator==(const Dict& other) const;
+
+	private:
+		std::pmr::vector<value_type> items_;
+
+		const_iterator LowerBound(std::string_view key) const;
+	};
+
+	//memory resource which passes allocations to upstream resource and counts them
+	class CountingResource : public std::pmr::memory_resource {
+	public:
+		explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+			: upstream_(upstream) {
+		}
+
+		size_t GetAllocationsCount() const {
+			return allocations_count_;
+		}
+
+		size_t GetAllocatedBytes() const {
+			return allocated_bytes_;
+		}
+
+		size_t GetPeakBytes() const {
+			return peak_bytes_;
+		}
+
+	private:
+		std::pmr::memory_resource* upstream_;
+		size_t allocations_count_{};
+		size_t allocated_bytes_{};
+		size_t bytes_in_use_{};
+		size_t peak_bytes_{};
+
+		void* do_allocate(size_t bytes, size_t alignment) override;
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+	};
 
 	//        JSON
 	class ParsingError : public std::runtime_error {
@@ -23,6 +151,57 @@ namespace json {
 
 	Node LoadNode(std::istream&);
 
+	//parses one value from contiguous buffer, faster than istream version,
+	//arrays and dicts of result take memory from resource
+	Node LoadNode(std::string_view, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+	//reads whole stream to one buffer for LoadNode(std::string_view)
+	std::string ReadAll(std::istream&);
+
+	//receives parsed values one by one, so input can be processed without building nodes,
+	//keys and strings are valid only during the call
+	class SaxHandler {
+	public:
+		virtual ~SaxHandler() = default;
+
+		virtual void StartArray() = 0;
+
+		virtual void EndArray() = 0;
+
+		virtual void StartDict() = 0;
+
+		virtual void EndDict() = 0;
+
+		virtual void Key(std::string_view key) = 0;
+
+		virtual void Value(std::nullptr_t) = 0;
+
+		virtual void Value(bool value) = 0;
+
+		virtual void Value(int value) = 0;
+
+		virtual void Value(double value) = 0;
+
+		virtual void Value(std::string_view value) = 0;
+	};
+
+	//parses one value from contiguous buffer as LoadNode does and passes its parts to handler in input order
+	void ParseSax(std::string_view input, SaxHandler& handler);
+
+	//parses values separated by commas, as items of array without brackets, array events are not passed
+	void ParseSaxItems(std::string_view input, SaxHandler& handler);
+
+	//value of root dict found without parsing
+	struct RootValue {
+		std::string_view key; //as it is written, escapes are not processed
+		std::string_view value;
+		std::vector<std::string_view> items; //items of array value, so they can be parsed separately
+	};
+
+	//finds values of root dict and items of its arrays by structural index, only borders of values
+	//are checked, values are checked when they are parsed
+	std::vector<RootValue> SplitRootDict(std::string_view input);
+
 	class Node final : 
         private std::variant<std::nullptr_t, Array, Dict, std::string_view, int, double, bool, std::string> {
 	public: 
@@ -106,6 +285,19 @@ namespace json {
             return std::get<std::string>(*this);
         }
 
+        //text node can own its chars or refer to parsed document buffer
+        bool IsText() const {
+            return IsString() || IsStringView();
+        }
+        std::string_view AsText() const {
+            using namespace std::literals;
+            if (!IsText()) {
+                throw std::logic_error("Not a text"s);
+            }
+
+            return IsString() ? std::string_view(std::get<std::string>(*this)) : std::get<std::string_view>(*this);
+        }
+
         bool IsDict() const {
             return std::holds_alternative<Dict>(*this);
         }
@@ -131,6 +323,116 @@ namespace json {
         }
 	};
 
-	void PrintJson(const Node& node, std::ostream& output);
+	//parsed document, strings and keys without escapes are views to input buffer,
+	//arrays and dicts are placed in document arena and released all at once with it
+	class Document {
+	public:
+		struct MemoryStats {
+			size_t nodes_allocations{}; //allocations made by arrays and dicts of document
+			size_t nodes_bytes{};
+			size_t heap_allocations{}; //arena chunks requested from heap
+			size_t heap_peak_bytes{};
+		};
+
+		//document takes ownership of input buffer
+		static Document Own(std::string input);
+
+		//input buffer must outlive document
+		static Document Borrow(std::string_view input);
+
+		const Node& GetRoot() const;
+
+		MemoryStats GetMemoryStats() const;
+
+	private:
+		Document(std::unique_ptr<const std::string> buffer, std::string_view input);
+
+		//arena takes chunks from heap_, nodes take memory from arena through nodes_
+		CountingResource heap_;
+		std::pmr::monotonic_buffer_resource arena_;
+		CountingResource nodes_;
+		std::unique_ptr<const std::string> buffer_;
+		Node root_;
+	};
+
+	enum class PrintMode {
+		PRETTY, //every array item and dict entry starts from new line
+		COMPACT, //without any whitespaces
+	};
+
+	//writes json text to internal buffer and passes it to stream by big blocks,
+	//so stream is not flushed and not called for every char
+	class Writer {
+	public:
+		explicit Writer(std::ostream& output, PrintMode mode = PrintMode::PRETTY);
+
+		Writer(const Writer&) = delete;
+
+		Writer& operator=(const Writer&) = delete;
+
+		~Writer();
+
+		Writer& StartArray();
+
+		Writer& EndArray();
+
+		Writer& StartDict();
+
+		Writer& EndDict();
+
+		Writer& Key(std::string_view key);
+
+		Writer& Value(std::nullptr_t);
+
+		Writer& Value(bool value);
+
+		Writer& Value(int value);
+
+		Writer& Value(double value);
+
+		Writer& Value(std::string_view value);
+
+		Writer& Value(const char* value);
+
+		Writer& Value(const std::string& value);
+
+		//writes whole node with all its items
+		Writer& Value(const Node& node);
+
+		//writes already serialized value as is, without escaping
+		Writer& RawValue(std::string_view text);
+
+		//continues value started by RawValue
+		Writer& Raw(std::string_view text);
+
+		//count of chars written since construction
+		size_t Position() const;
+
+		//passes buffered text to stream
+		void Flush();
+
+	private:
+		static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+		std::ostream& output_;
+		const PrintMode mode_;
+		std::string buffer_;
+		size_t flushed_ = 0;
+		//for every opened container: true if no items were written to it yet
+		std::vector<bool> first_item_;
+		bool after_key_ = false;
+
+		void BeforeValue();
+
+		void WriteSeparator();
+
+		void Append(std::string_view text);
+
+		void Append(char c);
+
+		void AppendEscaped(std::string_view text);
+	};
+
+	void PrintJson(const Node& node, std::ostream& output, PrintMode mode = PrintMode::PRETTY);
 
 }  // namespace json
\ No newline at end of file
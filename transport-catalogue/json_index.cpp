@@ -0,0 +1,258 @@
+#include "json_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace json {
+	namespace {
+		int CountTrailingZeros(uint64_t bits) {
+#if defined(__GNUC__)
+			return __builtin_ctzll(bits);
+#else
+			int count = 0;
+			while ((bits & 1) == 0) {
+				bits >>= 1;
+				++count;
+			};
+			return count;
+#endif
+		}
+
+		//i-th bit of result is xor of bits 0...i, so chars between opening and closing quotes are set
+		uint64_t PrefixXor(uint64_t bits) {
+			bits ^= bits << 1;
+			bits ^= bits << 2;
+			bits ^= bits << 4;
+			bits ^= bits << 8;
+			bits ^= bits << 16;
+			bits ^= bits << 32;
+			return bits;
+		}
+
+		void ComputeBlocksMasksScalar(const char* data, size_t blocks_count, BlockMasks* masks) {
+			for (size_t block = 0; block < blocks_count; ++block) {
+				BlockMasks& block_masks = masks[block] = BlockMasks{};
+				for (size_t i = 0; i < StructuralIndexer::BLOCK_SIZE; ++i) {
+					const uint64_t bit = uint64_t(1) << i;
+					switch (data[block * StructuralIndexer::BLOCK_SIZE + i]) {
+					case '"': block_masks.quotes |= bit; break;
+					case '\\': block_masks.backslashes |= bit; break;
+					case '{': case '}': case '[': case ']': case ':': case ',': block_masks.operators |= bit; break;
+					case ' ': case '\t': case '\n': case '\r': block_masks.whitespaces |= bit; break;
+					default: break;
+					}
+				};
+			};
+		}
+
+#if defined(__GNUC__) && defined(__x86_64__)
+		//places comparison result of part of block to its bits
+		uint64_t ToBits(__m128i mask, int part) {
+			return static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(mask))) << (part * 16);
+		}
+
+		__attribute__((target("avx2"))) uint64_t ToBits(__m256i mask, int part) {
+			return static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(mask))) << (part * 32);
+		}
+
+		//brackets differ from braces by one bit: '[' | 0x20 == '{' and ']' | 0x20 == '}',
+		//so all operators need only 4 comparisons
+		void ComputeBlocksMasksSse2(const char* data, size_t blocks_count, BlockMasks* masks) {
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i backslash = _mm_set1_epi8('\\');
+			const __m128i case_bit = _mm_set1_epi8(0x20);
+			const __m128i open_brace = _mm_set1_epi8('{');
+			const __m128i close_brace = _mm_set1_epi8('}');
+			const __m128i colon = _mm_set1_epi8(':');
+			const __m128i comma = _mm_set1_epi8(',');
+			const __m128i space = _mm_set1_epi8(' ');
+			const __m128i tab = _mm_set1_epi8('\t');
+			const __m128i line_feed = _mm_set1_epi8('\n');
+			const __m128i carriage_return = _mm_set1_epi8('\r');
+
+			for (size_t block = 0; block < blocks_count; ++block) {
+				BlockMasks& block_masks = masks[block] = BlockMasks{};
+				for (int part = 0; part < 4; ++part) {
+					const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + block * StructuralIndexer::BLOCK_SIZE + part * 16));
+					const __m128i lower = _mm_or_si128(chars, case_bit);
+					block_masks.quotes |= ToBits(_mm_cmpeq_epi8(chars, quote), part);
+					block_masks.backslashes |= ToBits(_mm_cmpeq_epi8(chars, backslash), part);
+					block_masks.operators |= ToBits(_mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(lower, open_brace), _mm_cmpeq_epi8(lower, close_brace)),
+						_mm_or_si128(_mm_cmpeq_epi8(chars, colon), _mm_cmpeq_epi8(chars, comma))), part);
+					block_masks.whitespaces |= ToBits(_mm_or_si128(
+						_mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, tab)),
+						_mm_or_si128(_mm_cmpeq_epi8(chars, line_feed), _mm_cmpeq_epi8(chars, carriage_return))), part);
+				};
+			};
+		}
+
+		__attribute__((target("avx2"))) void ComputeBlocksMasksAvx2(const char* data, size_t blocks_count, BlockMasks* masks) {
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i backslash = _mm256_set1_epi8('\\');
+			const __m256i case_bit = _mm256_set1_epi8(0x20);
+			const __m256i open_brace = _mm256_set1_epi8('{');
+			const __m256i close_brace = _mm256_set1_epi8('}');
+			const __m256i colon = _mm256_set1_epi8(':');
+			const __m256i comma = _mm256_set1_epi8(',');
+			const __m256i space = _mm256_set1_epi8(' ');
+			const __m256i tab = _mm256_set1_epi8('\t');
+			const __m256i line_feed = _mm256_set1_epi8('\n');
+			const __m256i carriage_return = _mm256_set1_epi8('\r');
+
+			for (size_t block = 0; block < blocks_count; ++block) {
+				BlockMasks& block_masks = masks[block] = BlockMasks{};
+				for (int part = 0; part < 2; ++part) {
+					const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + block * StructuralIndexer::BLOCK_SIZE + part * 32));
+					const __m256i lower = _mm256_or_si256(chars, case_bit);
+					block_masks.quotes |= ToBits(_mm256_cmpeq_epi8(chars, quote), part);
+					block_masks.backslashes |= ToBits(_mm256_cmpeq_epi8(chars, backslash), part);
+					block_masks.operators |= ToBits(_mm256_or_si256(
+						_mm256_or_si256(_mm256_cmpeq_epi8(lower, open_brace), _mm256_cmpeq_epi8(lower, close_brace)),
+						_mm256_or_si256(_mm256_cmpeq_epi8(chars, colon), _mm256_cmpeq_epi8(chars, comma))), part);
+					block_masks.whitespaces |= ToBits(_mm256_or_si256(
+						_mm256_or_si256(_mm256_cmpeq_epi8(chars, space), _mm256_cmpeq_epi8(chars, tab)),
+						_mm256_or_si256(_mm256_cmpeq_epi8(chars, line_feed), _mm256_cmpeq_epi8(chars, carriage_return))), part);
+				};
+			};
+		}
+#endif
+	}//end of anonymous namespace
+
+	bool IsKernelSupported(MasksKernel kernel) {
+		switch (kernel) {
+		case MasksKernel::SCALAR:
+			return true;
+#if defined(__GNUC__) && defined(__x86_64__)
+		case MasksKernel::SSE2:
+			//SSE2 is always supported by x86-64
+			return true;
+		case MasksKernel::AVX2:
+			return __builtin_cpu_supports("avx2");
+#endif
+		default:
+			return false;
+		};
+	}
+
+	MasksKernel GetBestMasksKernel() {
+		static const MasksKernel best = IsKernelSupported(MasksKernel::AVX2) ? MasksKernel::AVX2
+			: IsKernelSupported(MasksKernel::SSE2) ? MasksKernel::SSE2
+			: MasksKernel::SCALAR;
+		return best;
+	}
+
+	void ComputeBlocksMasks(MasksKernel kernel, const char* data, size_t blocks_count, BlockMasks* masks) {
+		if (!IsKernelSupported(kernel)) {
+			throw std::invalid_argument("Masks kernel is not supported");
+		};
+		switch (kernel) {
+#if defined(__GNUC__) && defined(__x86_64__)
+		case MasksKernel::AVX2:
+			ComputeBlocksMasksAvx2(data, blocks_count, masks);
+			break;
+		case MasksKernel::SSE2:
+			ComputeBlocksMasksSse2(data, blocks_count, masks);
+			break;
+#endif
+		default:
+			ComputeBlocksMasksScalar(data, blocks_count, masks);
+			break;
+		};
+	}
+
+	void ComputeBlocksMasks(const char* data, size_t blocks_count, BlockMasks* masks) {
+		ComputeBlocksMasks(GetBestMasksKernel(), data, blocks_count, masks);
+	}
+
+	StructuralIndexer::StructuralIndexer(std::string_view input) : input_(input) {
+	}
+
+	size_t StructuralIndexer::IndexNext(size_t blocks_count) {
+		//small inputs dont need buffer for all blocks
+		blocks_count = std::min(blocks_count, (input_.size() - offset_ + BLOCK_SIZE - 1) / BLOCK_SIZE);
+		if (positions_.size() < blocks_count * BLOCK_SIZE) {
+			positions_.resize(blocks_count * BLOCK_SIZE);
+		};
+		positions_count_ = 0;
+
+		BlockMasks masks[MASKS_BATCH];
+		const size_t full_blocks = std::min(blocks_count, (input_.size() - offset_) / BLOCK_SIZE);
+		for (size_t done = 0; done < full_blocks; done += MASKS_BATCH) {
+			const size_t count = std::min(MASKS_BATCH, full_blocks - done);
+			ComputeBlocksMasks(input_.data() + offset_, count, masks);
+			for (size_t i = 0; i < count; ++i) {
+				IndexBlock(masks[i], offset_);
+				offset_ += BLOCK_SIZE;
+			};
+		};
+
+		//last block is shorter, it is copied and filled by spaces, which are never indexed
+		if (full_blocks < blocks_count && offset_ < input_.size()) {
+			char block[BLOCK_SIZE];
+			std::memset(block, ' ', BLOCK_SIZE);
+			std::memcpy(block, input_.data() + offset_, input_.size() - offset_);
+			ComputeBlocksMasks(block, 1, masks);
+			IndexBlock(masks[0], offset_);
+			offset_ = input_.size();
+		};
+		return positions_count_;
+	}
+
+	const size_t* StructuralIndexer::Positions() const {
+		return positions_.data();
+	}
+
+	bool StructuralIndexer::IsFinished() const {
+		return offset_ == input_.size();
+	}
+
+	size_t StructuralIndexer::BackslashesEnd() const {
+		return backslashes_end_;
+	}
+
+	void StructuralIndexer::IndexBlock(const BlockMasks& masks, size_t offset) {
+		//char is escaped if it follows backslash which is not escaped itself.
+		//backslashes are rare, so they are walked one by one
+		uint64_t escaped = escaped_ ? 1 : 0;
+		uint64_t backslashes = masks.backslashes & ~escaped;
+		escaped_ = false;
+		if (backslashes != 0) {
+			backslashes_end_ = offset + BLOCK_SIZE;
+		};
+		while (backslashes != 0) {
+			const int index = CountTrailingZeros(backslashes);
+			if (index == 63) {
+				escaped_ = true;
+				break;
+			};
+			escaped |= uint64_t(1) << (index + 1);
+			backslashes &= ~(uint64_t(3) << index);
+		};
+
+		//opening quote is a part of string, closing one is not
+		const uint64_t quotes = masks.quotes & ~escaped;
+		const uint64_t in_string = PrefixXor(quotes) ^ in_string_;
+		in_string_ = (in_string >> 63) != 0 ? ~uint64_t(0) : 0;
+
+		//numbers and literals are indexed by their first chars
+		const uint64_t scalars = ~(masks.operators | masks.whitespaces | quotes | in_string);
+		const uint64_t scalars_starts = scalars & ~((scalars << 1) | (scalar_ ? 1 : 0));
+		scalar_ = (scalars >> 63) != 0;
+
+		//buffer has place for all chars of indexed blocks, so count is not checked
+		uint64_t tokens = (masks.operators & ~in_string) | quotes | scalars_starts;
+		size_t* positions = positions_.data() + positions_count_;
+		while (tokens != 0) {
+			*positions++ = offset + CountTrailingZeros(tokens);
+			tokens &= tokens - 1;
+		};
+		positions_count_ = static_cast<size_t>(positions - positions_.data());
+	}
+
+}//end of namespace json
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace json {
+
+	//chars of 64 bytes block as bit masks, i-th bit is set for i-th char of block
+	struct BlockMasks {
+		uint64_t quotes{};
+		uint64_t backslashes{};
+		uint64_t operators{}; //{ } [ ] : ,
+		uint64_t whitespaces{};
+	};
+
+	//scalar kernel is built for every processor, SSE2 and AVX2 ones only for x86-64
+	enum class MasksKernel {
+		SCALAR, //one char at once
+		SSE2, //16 chars at once
+		AVX2, //32 chars at once
+	};
+
+	//kernel is built for this target and processor has its instructions
+	bool IsKernelSupported(MasksKernel kernel);
+
+	//widest supported kernel, processor is checked once
+	MasksKernel GetBestMasksKernel();
+
+	//classifies chars of blocks_count blocks of 64 bytes, all kernels give the same masks.
+	//throws std::invalid_argument if kernel is not supported
+	void ComputeBlocksMasks(MasksKernel kernel, const char* data, size_t blocks_count, BlockMasks* masks);
+
+	//computed by best kernel
+	void ComputeBlocksMasks(const char* data, size_t blocks_count, BlockMasks* masks);
+
+	//finds positions where parser has to stop: structural chars, both quotes of every string and first chars
+	//of numbers and literals. chars of strings and escaped quotes are skipped, so parser doesnt visit
+	//whitespaces and chars of strings without escapes at all. input is indexed by parts, so index
+	//of big input doesnt take memory proportional to its size
+	class StructuralIndexer {
+	public:
+		static constexpr size_t BLOCK_SIZE = 64;
+		static constexpr size_t DEFAULT_BLOCKS = 256;
+
+		explicit StructuralIndexer(std::string_view input);
+
+		//indexes next blocks_count blocks of input, returns count of found positions.
+		//positions are placed to Positions() and are valid until next call
+		size_t IndexNext(size_t blocks_count = DEFAULT_BLOCKS);
+
+		const size_t* Positions() const;
+
+		bool IsFinished() const;
+
+		//position after last backslash which was met, 0 if there were no backslashes,
+		//so strings which start after it dont need to be checked for escapes
+		size_t BackslashesEnd() const;
+
+	private:
+		static constexpr size_t MASKS_BATCH = 16;
+
+		std::string_view input_;
+		size_t offset_ = 0;
+		std::vector<size_t> positions_{}; //positions of last indexed blocks
+		size_t positions_count_ = 0;
+		size_t backslashes_end_ = 0;
+		//state of previous block
+		uint64_t in_string_ = 0; //all bits are set if block ended inside string
+		bool escaped_ = false; //block ended by backslash which escapes first char of next block
+		bool scalar_ = false; //block ended by chars of number or literal
+
+		void IndexBlock(const BlockMasks& masks, size_t offset);
+	};
+
+}//end of namespace json
\ No newline at end of file
@@ -1,79 +1,624 @@
 #include "json_reader.h"
+#include "json_builder.h"
+#include <initializer_list>
 
 namespace json {
 
 	using namespace std::string_literals;
+	using namespace std::string_view_literals;
 
 	void JsonReader::LoadData(std::istream& input, render::MapRenderer& renderer) {
-		Node json_node = LoadNode(input);
+		const std::string buffer = ReadAll(input);
+		LoadData(buffer, renderer);
+	}
+
+	void JsonReader::LoadData(std::string_view input, render::MapRenderer& renderer) {
+		//strings of document refer to input, all needed data is copied from it before return
+		const Document document = Document::Borrow(input);
+		load_stats_.document = document.GetMemoryStats();
+
+		//document is walked by references, containers which collect pointers to its objects
+		//take memory from this counter, so walk costs only these allocations
+		CountingResource walk_counter;
 
-		auto& all_requests = json_node.AsDict();
+		auto& all_requests = document.GetRoot().AsDict();
 
 		//process base requests
-		ProcessStopsAndBuses(all_requests.at("base_requests"s).AsArray());
+		ProcessStopsAndBuses(all_requests.at("base_requests"sv).AsArray(), &walk_counter);
 		//process render settings
-		ProcessRenderSettings(renderer, all_requests.at("render_settings"s).AsDict());
+		ProcessRenderSettings(renderer, all_requests.at("render_settings"sv).AsDict());
 		//process stat requests
-		ProcessRequests(all_requests.at("stat_requests"s).AsArray());
+		ProcessRequests(all_requests.at("stat_requests"sv).AsArray());
+
+		load_stats_.walk_allocations = walk_counter.GetAllocationsCount();
 	}
 
-	void JsonReader::Print(std::ostream& out, const std::vector<objects::RequestAnswer>& data) {
-		using stop_data = std::vector<std::string>;
-		using bus_data = objects::RouteData;
-		using svg_map = std::string_view;
-		using error = bool;
+	//passes every base request to catalogue as soon as it is parsed, render settings are collected
+	//to small dict and stat requests are added to reader. stops which are not added yet are resolved
+	//when all base requests are parsed
+	class JsonReader::CatalogueLoader final : public SaxHandler {
+	public:
+		CatalogueLoader(JsonReader& reader, render::MapRenderer& renderer, transport::Catalogue& catalogue)
+			: reader_(reader), renderer_(renderer), catalogue_(catalogue) {
+		}
+
+		//root dict is split to values by pre-scan, items of base requests are parsed by workers
+		//chunk by chunk and are added to catalogue in input order, other values are parsed here
+		void LoadInParallel(std::string_view input, parallel::ThreadPool& workers) {
+			for (const RootValue& root_value : SplitRootDict(input)) {
+				//every value is parsed as if root dict was opened and key of value was passed
+				depth_ = 1;
+				Key(root_value.key);
+				if (section_ == Section::BASE_REQUESTS && !root_value.items.empty()) {
+					LoadBaseRequests(root_value.items, workers);
+				}
+				else {
+					ParseSax(root_value.value, *this);
+				};
+			};
+		}
+
+		void StartArray() override {
+			if (InRenderSettings(depth_)) {
+				settings_.StartArray();
+			};
+			++depth_;
+		}
 
-		Builder builder{};
-		builder.StartArray();
+		void EndArray() override {
+			--depth_;
+			if (InRenderSettings(depth_)) {
+				settings_.EndArray();
+			}
+			else if (depth_ == 1 && section_ == Section::BASE_REQUESTS) {
+				ResolvePendingStops();
+			};
+		}
 
-		for (const auto& answer : data) {
-			builder.StartDict().Key("request_id"s).Value(answer.id);
+		void StartDict() override {
+			if (InRenderSettings(depth_)) {
+				settings_.StartDict();
+			}
+			else if (depth_ == 2) {
+				object_.Clear();
+			};
+			++depth_;
+		}
+
+		void EndDict() override {
+			--depth_;
+			if (InRenderSettings(depth_)) {
+				settings_.EndDict();
+				if (depth_ == 1) {
+					const Node settings = settings_.Build();
+					reader_.ProcessRenderSettings(renderer_, settings.AsDict());
+					settings_ = Builder{};
+				};
+			}
+			else if (depth_ == 2 && section_ == Section::BASE_REQUESTS) {
+				if (chunk_ != nullptr) {
+					CollectBaseRequest();
+				}
+				else {
+					AddBaseRequest(object_);
+				};
+			}
+			else if (depth_ == 2 && section_ == Section::STAT_REQUESTS) {
+				AddStatRequest();
+			};
+		}
+
+		void Key(std::string_view key) override {
+			if (depth_ == 1) {
+				section_ = key == "base_requests"sv ? Section::BASE_REQUESTS
+					: key == "render_settings"sv ? Section::RENDER_SETTINGS
+					: key == "stat_requests"sv ? Section::STAT_REQUESTS
+					: Section::OTHER;
+			}
+			else if (InRenderSettings(depth_ - 1)) {
+				settings_.Key(std::string(key));
+			}
+			else if (depth_ == 3) {
+				field_ = FindField(key);
+				object_.given_fields |= 1u << static_cast<unsigned>(field_);
+			}
+			else if (depth_ == 4 && field_ == Field::ROAD_DISTANCES) {
+				object_.distance_stop = key;
+			};
+		}
+
+		void Value(std::nullptr_t) override {
+			OnValue(Node(nullptr));
+		}
+
+		void Value(bool value) override {
+			OnValue(Node(value));
+		}
+
+		void Value(int value) override {
+			OnValue(Node(value));
+		}
+
+		void Value(double value) override {
+			OnValue(Node(value));
+		}
+
+		void Value(std::string_view value) override {
+			OnValue(Node(value));
+		}
+
+	private:
+		enum class Section { NONE, BASE_REQUESTS, RENDER_SETTINGS, STAT_REQUESTS, OTHER };
+
+		enum class Field { TYPE, NAME, ID, LATITUDE, LONGITUDE, ROAD_DISTANCES, IS_ROUNDTRIP, STOPS, OTHER };
+
+		//fields of request which is parsed now, containers keep their memory for next requests
+		struct ParsedObject {
+			std::string type;
+			std::string name;
+			unsigned given_fields{}; //bit of every field which key is given
+			int id{};
+			geo::Coordinates coordinates{};
+			bool is_roundtrip{};
+			std::vector<std::string> stops;
+			size_t stops_count{};
+			std::vector<std::pair<std::string, int>> distances;
+			size_t distances_count{};
+			std::string distance_stop;
+			//filled when object is added to catalogue
+			const Stop* stop_ptr{};
+			const Bus* bus_ptr{};
+			bool is_given_again{}; //object with same name is added already, it is reused as DOCUMENT mode does
+			std::vector<const Stop*> found_stops; //stops of route or distances, nullptr if stop is not added yet
+
+			void Clear() {
+				type.clear();
+				name.clear();
+				given_fields = 0;
+				id = 0;
+				coordinates = {};
+				is_roundtrip = false;
+				stops_count = 0;
+				distances_count = 0;
+				stop_ptr = nullptr;
+				bus_ptr = nullptr;
+				is_given_again = false;
+			}
+
+			bool IsGiven(Field field) const {
+				return (given_fields & (1u << static_cast<unsigned>(field))) != 0;
+			}
+		};
+
+		//base requests parsed by worker, objects keep their memory for next chunks
+		struct ParsedChunk {
+			std::vector<ParsedObject> objects;
+			size_t count{};
+		};
+
+		struct PendingDistance {
+			const Stop* from;
+			std::string to;
+			int length;
+			const Stop* to_ptr = nullptr;
+		};
+
+		struct PendingBusStop {
+			const Bus* bus;
+			size_t index;
+			std::string stop;
+			const Stop* stop_ptr = nullptr;
+		};
+
+		JsonReader& reader_;
+		render::MapRenderer& renderer_;
+		transport::Catalogue& catalogue_;
+		size_t depth_ = 0; //count of opened arrays and dicts
+		Section section_ = Section::NONE;
+		Field field_ = Field::OTHER;
+		ParsedObject object_{};
+		Builder settings_{};
+		std::vector<PendingDistance> pending_distances_{};
+		std::vector<PendingBusStop> pending_bus_stops_{};
+		ParsedChunk* chunk_ = nullptr; //base requests are collected to chunk instead of catalogue if it is set
+
+		//base requests are given to workers by chunks, chunks are parsed by windows of several chunks per worker,
+		//so parsed requests which are not added yet dont take memory proportional to input size
+		static constexpr size_t BASE_REQUESTS_CHUNK = 256;
+		static constexpr size_t CHUNKS_PER_WORKER = 8;
+		static constexpr size_t PENDING_STOPS_CHUNK = 1024;
+
+		//loader of worker, items of base requests are parsed as if they were in base requests array
+		CatalogueLoader(JsonReader& reader, render::MapRenderer& renderer, transport::Catalogue& catalogue, ParsedChunk& chunk)
+			: reader_(reader), renderer_(renderer), catalogue_(catalogue), depth_(2), section_(Section::BASE_REQUESTS), chunk_(&chunk) {
+		}
+
+		//checks if array or dict which is opened at given depth belongs to render settings
+		bool InRenderSettings(size_t depth) const {
+			return section_ == Section::RENDER_SETTINGS && depth >= 1;
+		}
+
+		static Field FindField(std::string_view key) {
+			if (key == "type"sv) { return Field::TYPE; };
+			if (key == "name"sv) { return Field::NAME; };
+			if (key == "id"sv) { return Field::ID; };
+			if (key == "latitude"sv) { return Field::LATITUDE; };
+			if (key == "longitude"sv) { return Field::LONGITUDE; };
+			if (key == "road_distances"sv) { return Field::ROAD_DISTANCES; };
+			if (key == "is_roundtrip"sv) { return Field::IS_ROUNDTRIP; };
+			if (key == "stops"sv) { return Field::STOPS; };
+			return Field::OTHER;
+		}
+
+		void OnValue(const Node& value) {
+			if (InRenderSettings(depth_ - 1)) {
+				//escaped strings are temporary, so every string is copied to settings
+				if (value.IsStringView()) {
+					settings_.Value(std::string(value.AsStringView()));
+				}
+				else {
+					settings_.Value(value.GetValue());
+				};
+			}
+			else if (depth_ == 3) {
+				switch (field_) {
+				case Field::TYPE: object_.type = value.AsText(); break;
+				case Field::NAME: object_.name = value.AsText(); break;
+				case Field::ID: object_.id = value.AsInt(); break;
+				case Field::LATITUDE: object_.coordinates.lat = value.AsDouble(); break;
+				case Field::LONGITUDE: object_.coordinates.lng = value.AsDouble(); break;
+				case Field::IS_ROUNDTRIP: object_.is_roundtrip = value.AsBool(); break;
+				default: break;
+				}
+			}
+			else if (depth_ == 4 && field_ == Field::STOPS) {
+				if (object_.stops_count == object_.stops.size()) {
+					object_.stops.emplace_back();
+				};
+				object_.stops[object_.stops_count++] = value.AsText();
+			}
+			else if (depth_ == 4 && field_ == Field::ROAD_DISTANCES) {
+				if (object_.distances_count == object_.distances.size()) {
+					object_.distances.emplace_back();
+				};
+				auto& [stop, length] = object_.distances[object_.distances_count++];
+				stop = object_.distance_stop;
+				length = value.AsInt();
+			};
+		}
+
+		void LoadBaseRequests(const std::vector<std::string_view>& items, parallel::ThreadPool& workers) {
+			const size_t window_chunks = CHUNKS_PER_WORKER * workers.GetThreadsCount();
+			std::vector<ParsedChunk> chunks(window_chunks);
+			for (size_t window_begin = 0; window_begin < items.size(); window_begin += window_chunks * BASE_REQUESTS_CHUNK) {
+				const size_t window_size = std::min(window_chunks * BASE_REQUESTS_CHUNK, items.size() - window_begin);
+				workers.ParallelFor(window_size, BASE_REQUESTS_CHUNK, [&](size_t begin, size_t end) {
+					ParsedChunk& chunk = chunks[begin / BASE_REQUESTS_CHUNK];
+					chunk.count = 0;
+					//items of chunk are parsed together, text between them has only commas and whitespaces
+					const std::string_view first = items[window_begin + begin];
+					const std::string_view last = items[window_begin + end - 1];
+					CatalogueLoader loader(reader_, renderer_, catalogue_, chunk);
+					ParseSaxItems(std::string_view(first.data(), static_cast<size_t>(last.data() + last.size() - first.data())), loader);
+				});
+				//stops and buses get ids in input order, then stops names are looked up by workers,
+				//catalogue is not changed meanwhile. only found stops are set here
+				const size_t chunks_count = (window_size + BASE_REQUESTS_CHUNK - 1) / BASE_REQUESTS_CHUNK;
+				for (size_t i = 0; i < chunks_count; ++i) {
+					for (size_t j = 0; j < chunks[i].count; ++j) {
+						AddObject(chunks[i].objects[j]);
+					};
+				};
+				workers.ParallelFor(chunks_count, 1, [&](size_t begin, size_t end) {
+					for (size_t i = begin; i < end; ++i) {
+						for (size_t j = 0; j < chunks[i].count; ++j) {
+							FindObjectStops(chunks[i].objects[j]);
+						};
+					};
+				});
+				for (size_t i = 0; i < chunks_count; ++i) {
+					for (size_t j = 0; j < chunks[i].count; ++j) {
+						AddObjectStops(chunks[i].objects[j]);
+					};
+				};
+			};
+			ResolvePendingStops(&workers);
+		}
+
+		//parsed object is exchanged with object of chunk, so both keep their memory
+		void CollectBaseRequest() {
+			if (chunk_->count == chunk_->objects.size()) {
+				chunk_->objects.emplace_back();
+			};
+			std::swap(chunk_->objects[chunk_->count++], object_);
+		}
+
+		void AddBaseRequest(ParsedObject& object) {
+			AddObject(object);
+			FindObjectStops(object);
+			AddObjectStops(object);
+		}
 
-			//if data is vector - object is stop
-			if (std::holds_alternative<stop_data>(answer.data)) {
-				PrintStop(builder, std::get<stop_data>(answer.data));
+		//stop or bus which is given again gets last coordinates or route, distances of stop are merged,
+		//so catalogue is the same as in DOCUMENT mode
+		void AddObject(ParsedObject& object) {
+			CheckGiven(object, { { Field::TYPE, "type"sv } });
+			if (object.type == "Stop"sv) {
+				CheckGiven(object, { { Field::NAME, "name"sv }, { Field::LATITUDE, "latitude"sv }, { Field::LONGITUDE, "longitude"sv },
+					{ Field::ROAD_DISTANCES, "road_distances"sv } });
+				object.stop_ptr = catalogue_.FindStop(object.name);
+				object.is_given_again = object.stop_ptr != nullptr;
+				if (object.is_given_again) {
+					catalogue_.SetStopCoordinates(object.stop_ptr, object.coordinates);
+				}
+				else {
+					object.stop_ptr = catalogue_.AddStop(object.name, object.coordinates);
+				};
 			}
-			//if data is RouteData - object is bus
-			else if (std::holds_alternative<bus_data>(answer.data)) {
-				PrintBus(builder, std::get<bus_data>(answer.data));
+			else if (object.type == "Bus"sv) {
+				CheckGiven(object, { { Field::NAME, "name"sv }, { Field::IS_ROUNDTRIP, "is_roundtrip"sv }, { Field::STOPS, "stops"sv } });
+				//route is replaced in AddObjectStops, earlier requests of window add their stops before it
+				object.bus_ptr = catalogue_.FindBus(object.name);
+				object.is_given_again = object.bus_ptr != nullptr;
+				if (!object.is_given_again) {
+					object.bus_ptr = catalogue_.AddBus(object.name, object.is_roundtrip);
+				};
+			};
+		}
+
+		//only reads catalogue, so objects can be processed by several threads at once
+		void FindObjectStops(ParsedObject& object) const {
+			if (object.stop_ptr != nullptr) {
+				object.found_stops.resize(object.distances_count);
+				for (size_t i = 0; i < object.distances_count; ++i) {
+					object.found_stops[i] = catalogue_.FindStop(object.distances[i].first);
+				};
 			}
-			//case if data is map_renderer(string_view)
-			else if (std::holds_alternative<svg_map>(answer.data)) {
-				PrintSvgMap(builder, std::get<svg_map>(answer.data));
+			else if (object.bus_ptr != nullptr) {
+				object.found_stops.resize(object.stops_count);
+				for (size_t i = 0; i < object.stops_count; ++i) {
+					object.found_stops[i] = catalogue_.FindStop(object.stops[i]);
+				};
+			};
+		}
+
+		//stops which are not added yet are resolved when all base requests are added
+		void AddObjectStops(const ParsedObject& object) {
+			if (object.stop_ptr != nullptr) {
+				for (size_t i = 0; i < object.distances_count; ++i) {
+					const auto& [stop, length] = object.distances[i];
+					//distances of stop given again are set after pending ones, so last given length wins
+					if (const Stop* other_ptr = object.found_stops[i]; other_ptr != nullptr && !object.is_given_again) {
+						catalogue_.SetStopsDistance(object.stop_ptr, other_ptr, length);
+					}
+					else {
+						pending_distances_.push_back({ object.stop_ptr, stop, length });
+					};
+				};
 			}
-			//id data is error (bool) - object is error
-			else if (std::holds_alternative<error>(answer.data)) {
-				builder.Key("error_message"s).Value("not found"s);
+			else if (object.bus_ptr != nullptr) {
+				if (object.is_given_again) {
+					catalogue_.ResetBusRoute(object.bus_ptr, object.is_roundtrip);
+					pending_bus_stops_.erase(std::remove_if(pending_bus_stops_.begin(), pending_bus_stops_.end(),
+						[&object](const PendingBusStop& bus_stop) { return bus_stop.bus == object.bus_ptr; }), pending_bus_stops_.end());
+				};
+				for (size_t i = 0; i < object.stops_count; ++i) {
+					if (const Stop* stop_ptr = object.found_stops[i]) {
+						catalogue_.ExpandBusAndStopInfo(object.bus_ptr, stop_ptr);
+					}
+					else {
+						pending_bus_stops_.push_back({ object.bus_ptr, catalogue_.AddBusStopPlaceholder(object.bus_ptr), object.stops[i] });
+					};
+				};
+			};
+		}
+
+		void AddStatRequest() {
+			CheckGiven(object_, { { Field::ID, "id"sv }, { Field::TYPE, "type"sv } });
+			objects::Request request{};
+			request.id = object_.id;
+			request.type = object_.type;
+			if (object_.IsGiven(Field::NAME)) { //map request doesnt have name
+				request.name = object_.name;
+			};
+			reader_.parsed_requests.push_back(std::move(request));
+		}
+
+		//stops are looked up before catalogue is changed, so lookups can be shared between workers
+		void ResolvePendingStops(parallel::ThreadPool* workers = nullptr) {
+			const auto find_stops = [this](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) {
+					if (i < pending_distances_.size()) {
+						pending_distances_[i].to_ptr = catalogue_.FindStop(pending_distances_[i].to);
+					}
+					else {
+						PendingBusStop& bus_stop = pending_bus_stops_[i - pending_distances_.size()];
+						bus_stop.stop_ptr = catalogue_.FindStop(bus_stop.stop);
+					};
+				};
+			};
+			const size_t pending_count = pending_distances_.size() + pending_bus_stops_.size();
+			if (workers == nullptr) {
+				find_stops(0, pending_count);
+			}
+			else {
+				workers->ParallelFor(pending_count, PENDING_STOPS_CHUNK, find_stops);
+			};
+
+			for (const auto& distance : pending_distances_) {
+				catalogue_.SetStopsDistance(distance.from, CheckAdded(distance.to_ptr, distance.to), distance.length);
+			};
+			for (const auto& bus_stop : pending_bus_stops_) {
+				catalogue_.SetBusStop(bus_stop.bus, bus_stop.index, CheckAdded(bus_stop.stop_ptr, bus_stop.stop));
+			};
+			pending_distances_.clear();
+			pending_bus_stops_.clear();
+		}
+
+		//missing keys give the same error as in DOCUMENT mode, keys are checked in the same order
+		static void CheckGiven(const ParsedObject& object, std::initializer_list<std::pair<Field, std::string_view>> fields) {
+			for (const auto& [field, key] : fields) {
+				if (!object.IsGiven(field)) {
+					throw std::out_of_range("Key is not found: "s + std::string(key));
+				};
+			};
+		}
+
+		static const Stop* CheckAdded(const Stop* stop_ptr, const std::string& name) {
+			if (stop_ptr == nullptr) {
+				throw std::out_of_range("Stop is not found: "s + name);
+			};
+			return stop_ptr;
+		}
+	};
+
+	void JsonReader::LoadData(std::istream& input, render::MapRenderer& renderer, transport::Catalogue& catalogue,
+		parallel::ThreadPool* workers) {
+		const std::string buffer = ReadAll(input);
+		LoadData(buffer, renderer, catalogue, workers);
+	}
+
+	void JsonReader::LoadData(std::string_view input, render::MapRenderer& renderer, transport::Catalogue& catalogue,
+		parallel::ThreadPool* workers) {
+		CatalogueLoader loader(*this, renderer, catalogue);
+		if (workers != nullptr && workers->GetThreadsCount() > 1) {
+			loader.LoadInParallel(input, *workers);
+		}
+		else {
+			ParseSax(input, loader);
+		};
+	}
+
+	void JsonReader::LoadStatRequests(std::string_view input) {
+		for (const RootValue& root_value : SplitRootDict(input)) {
+			if (root_value.key == "stat_requests"sv) {
+				ProcessRequests(LoadNode(root_value.value).AsArray());
 			};
+		};
+	}
 
-			builder.EndDict();
+	const JsonReader::LoadStats& JsonReader::GetLoadStats() const {
+		return load_stats_;
+	}
+
+	void JsonReader::Print(std::ostream& out, const std::vector<objects::RequestAnswer>& data) {
+		StartAnswers(out);
+		for (const auto& answer : data) {
+			PrintAnswer(answer);
 		};
+		FinishAnswers();
+	}
+
+	void JsonReader::StartAnswers(std::ostream& out) {
+		answers_writer_ = std::make_unique<Writer>(out);
+		answers_writer_->StartArray();
+	}
+
+	void JsonReader::PrintAnswer(const objects::RequestAnswer& answer) {
+		WriteAnswer(*answers_writer_, answer);
+	}
+
+	void JsonReader::PrintAnswer(const AnswerFragment& fragment, int id) {
+		WriteAnswer(*answers_writer_, fragment, id);
+	}
+
+	void JsonReader::PrintSerializedAnswer(std::string_view answer) {
+		answers_writer_->RawValue(answer);
+	}
+
+	AnswerFragment JsonReader::SerializeAnswer(const objects::RequestAnswer& answer) const {
+		std::ostringstream stream;
+		IdPosition id_position{};
+		{
+			Writer writer(stream);
+			id_position = WriteAnswerItems(writer, answer);
+		}
+		return AnswerFragment{ stream.str(), id_position.position, id_position.length };
+	}
+
+	void JsonReader::WriteAnswer(Writer& writer, const objects::RequestAnswer& answer) const {
+		WriteAnswerItems(writer, answer);
+	}
 
-		builder.EndArray();
-		PrintJson(builder.Build(), out);
+	void JsonReader::WriteAnswer(Writer& writer, const AnswerFragment& fragment, int id) const {
+		char number[16];
+		const auto result = std::to_chars(number, number + sizeof(number), id);
+		writer.RawValue(fragment.Prefix())
+			.Raw(std::string_view(number, static_cast<size_t>(result.ptr - number)))
+			.Raw(fragment.Suffix());
 	}
 
-	void JsonReader::PrintStop(Builder& builder, const std::vector<std::string>& buses) {
-		builder.Key("buses"s).StartArray();
+	JsonReader::IdPosition JsonReader::WriteAnswerItems(Writer& writer, const objects::RequestAnswer& answer) const {
+		using stop_data = std::vector<std::string>;
+		using bus_data = objects::RouteData;
+		using svg_map = std::string_view;
+		using error = bool;
+
+		writer.StartDict();
+		IdPosition id_position{};
+
+		//keys of every answer are written in alphabetical order, as json::Dict keeps them
+		//if data is vector - object is stop
+		if (std::holds_alternative<stop_data>(answer.data)) {
+			id_position = PrintStop(writer, answer.id, std::get<stop_data>(answer.data));
+		}
+		//if data is RouteData - object is bus
+		else if (std::holds_alternative<bus_data>(answer.data)) {
+			id_position = PrintBus(writer, answer.id, std::get<bus_data>(answer.data));
+		}
+		//case if data is map_renderer(string_view)
+		else if (std::holds_alternative<svg_map>(answer.data)) {
+			id_position = PrintSvgMap(writer, answer.id, std::get<svg_map>(answer.data));
+		}
+		//id data is error (bool) - object is error
+		else if (std::holds_alternative<error>(answer.data)) {
+			id_position = PrintError(writer, answer.id, std::get<error>(answer.data));
+		};
+
+		writer.EndDict();
+		return id_position;
+	}
+
+	void JsonReader::FinishAnswers() {
+		answers_writer_->EndArray();
+		answers_writer_.reset();
+	}
+
+	JsonReader::IdPosition JsonReader::PrintStop(Writer& writer, int id, const std::vector<std::string>& buses) const {
+		writer.Key("buses"sv).StartArray();
 		for (const auto& bus : buses) {
-			builder.Value(bus);
+			writer.Value(bus);
 		};
-		builder.EndArray();
+		writer.EndArray();
+		return PrintRequestId(writer, id);
 	}
 
-	void JsonReader::PrintBus(Builder& builder, const objects::RouteData& data) {
-		builder.Key("curvature"s).Value(data.curvature);
-		builder.Key("route_length"s).Value(int(data.length));
-		builder.Key("stop_count"s).Value(int(data.stops_count));
-		builder.Key("unique_stop_count"s).Value(int(data.unique_stops));
+	JsonReader::IdPosition JsonReader::PrintBus(Writer& writer, int id, const objects::RouteData& data) const {
+		writer.Key("curvature"sv).Value(data.curvature);
+		const IdPosition id_position = PrintRequestId(writer, id);
+		writer.Key("route_length"sv).Value(int(data.length));
+		writer.Key("stop_count"sv).Value(int(data.stops_count));
+		writer.Key("unique_stop_count"sv).Value(int(data.unique_stops));
+		return id_position;
 	}
 
-	void JsonReader::PrintSvgMap(Builder& builder, const std::string_view& svg_map) {
-		builder.Key("map"s).Value(svg_map);
+	JsonReader::IdPosition JsonReader::PrintSvgMap(Writer& writer, int id, const std::string_view& svg_map) const {
+		writer.Key("map"sv).Value(svg_map);
+		return PrintRequestId(writer, id);
 	}
 
-	void JsonReader::PrintError(Builder& builder, const bool) {
-		builder.Key("error_message"s).Value("not found"s);
+	JsonReader::IdPosition JsonReader::PrintError(Writer& writer, int id, const bool) const {
+		writer.Key("error_message"sv).Value("not found"sv);
+		return PrintRequestId(writer, id);
+	}
+
+	JsonReader::IdPosition JsonReader::PrintRequestId(Writer& writer, int id) const {
+		writer.Key("request_id"sv);
+		IdPosition id_position{};
+		id_position.position = writer.Position();
+		writer.Value(id);
+		id_position.length = writer.Position() - id_position.position;
+		return id_position;
 	}
 
 	const std::map<std::string, geo::Coordinates>& JsonReader::GetParsedStops() {
@@ -92,26 +637,27 @@ namespace json {
 		return parsed_buses_routes_;
 	}
 
-	void JsonReader::ProcessStopsAndBuses(std::vector<Node> stops_and_buses) {
-		std::vector<Dict> stops, buses;
+	void JsonReader::ProcessStopsAndBuses(const Array& stops_and_buses, std::pmr::memory_resource* resource) {
+		//objects are not copied, only pointers to document dicts are collected
+		std::pmr::vector<const Dict*> stops(resource), buses(resource);
 		for (const auto& object : stops_and_buses) {
-			std::string obj_type{ object.AsDict().at("type").AsString() };
+			std::string_view obj_type{ object.AsDict().at("type"sv).AsText() };
 
 			if (obj_type == "Stop") {
-				stops.push_back(object.AsDict());
+				stops.push_back(&object.AsDict());
 			}
 			else if (obj_type == "Bus") {
-				buses.push_back(object.AsDict());
+				buses.push_back(&object.AsDict());
 			};
 		};
 
-		ParseStops(std::move(stops));
-		ParseBuses(std::move(buses));
+		ParseStops(stops);
+		ParseBuses(buses);
 	}
 
 	std::string ProcessColor(const Node& underlayer_color) {
-		if (underlayer_color.IsString()) {
-			return underlayer_color.AsString();
+		if (underlayer_color.IsText()) {
+			return std::string(underlayer_color.AsText());
 		}
 		else {
 			std::string color = underlayer_color.AsArray().size() == 3 ? "rgb("s : "rgba("s;
@@ -136,20 +682,20 @@ namespace json {
 		};
 	}
 
-	void JsonReader::ProcessRenderSettings(render::MapRenderer& renderer, std::map<std::string, Node> render_settings) {
+	void JsonReader::ProcessRenderSettings(render::MapRenderer& renderer, const Dict& render_settings) {
 		//filling all MapRenderer settings
-		renderer.SetWidthAndHeight(render_settings.at("width"s).AsDouble(), render_settings.at("height"s).AsDouble());
-		renderer.SetPadding(render_settings.at("padding"s).AsDouble());
-		renderer.SetStopRadius(render_settings.at("stop_radius"s).AsDouble());
-		renderer.SetLineWidth(render_settings.at("line_width"s).AsDouble());
-		renderer.SetBusAndStopsFontsSize(render_settings.at("bus_label_font_size"s).AsInt(), render_settings.at("stop_label_font_size"s).AsInt());
+		renderer.SetWidthAndHeight(render_settings.at("width"sv).AsDouble(), render_settings.at("height"sv).AsDouble());
+		renderer.SetPadding(render_settings.at("padding"sv).AsDouble());
+		renderer.SetStopRadius(render_settings.at("stop_radius"sv).AsDouble());
+		renderer.SetLineWidth(render_settings.at("line_width"sv).AsDouble());
+		renderer.SetBusAndStopsFontsSize(render_settings.at("bus_label_font_size"sv).AsInt(), render_settings.at("stop_label_font_size"sv).AsInt());
 		//processing offset arrays with double
-		std::vector<Node> bus_offset = render_settings.at("bus_label_offset").AsArray();
-		std::vector<Node> stop_offset = render_settings.at("stop_label_offset").AsArray();
+		const Array& bus_offset = render_settings.at("bus_label_offset"sv).AsArray();
+		const Array& stop_offset = render_settings.at("stop_label_offset"sv).AsArray();
 		renderer.SetBusAndStopLabelsOffset(bus_offset[0].AsDouble(), bus_offset[1].AsDouble(),
 			stop_offset[0].AsDouble(), stop_offset[1].AsDouble());
 		renderer.SetUnderlayerColor(ProcessColor(render_settings.at("underlayer_color")));
-		renderer.SetUnderlayerWidth(render_settings.at("underlayer_width"s).AsDouble());
+		renderer.SetUnderlayerWidth(render_settings.at("underlayer_width"sv).AsDouble());
 
 		//getting all colors as strings from array
 		std::vector<std::string> color_palette;
@@ -159,67 +705,61 @@ namespace json {
 		renderer.SetColorPalette(color_palette);
 	}
 
-	void JsonReader::ProcessRequests(std::vector<Node> requests) {
+	void JsonReader::ProcessRequests(const Array& requests) {
 		for (const auto& node_request : requests) {
 			//convert request type Node to map
 			const auto& request_ = node_request.AsDict();
 			//getting id of request, type of requested object and its name
 			objects::Request request{};
-			request.id = request_.at("id"s).AsInt();
-			request.type = request_.at("type"s).AsString();
-			if (request_.count("name"s)) { //map request doesnt have name
-				request.name = request_.at("name"s).AsString();
+			request.id = request_.at("id"sv).AsInt();
+			request.type = request_.at("type"sv).AsText();
+			if (request_.count("name"sv)) { //map request doesnt have name
+				request.name = request_.at("name"sv).AsText();
 			};
 			//filling parsed requests
 			parsed_requests.push_back(request);
 		};
 	}
 
-	void JsonReader::ParseStops(std::vector<Dict> stops) {
-		for (const auto& object : stops) {
-			const std::string& stop_name = object.at("name"s).AsString();
+	void JsonReader::ParseStops(const std::pmr::vector<const Dict*>& stops) {
+		for (const Dict* object_ptr : stops) {
+			const Dict& object = *object_ptr;
+			const std::string stop_name{ object.at("name"sv).AsText() };
 
 			geo::Coordinates coordinates{};
-			coordinates.lat = object.at("latitude"s).AsDouble();
-			coordinates.lng = object.at("longitude"s).AsDouble();
+			coordinates.lat = object.at("latitude"sv).AsDouble();
+			coordinates.lng = object.at("longitude"sv).AsDouble();
 			//adding stop to reader container
 			parsed_stops_[stop_name] = coordinates;
 			//adding road distances to reader container
-			const std::map<std::string, Node>& distances = { object.at("road_distances"s).AsDict() };
+			const Dict& distances = { object.at("road_distances"sv).AsDict() };
 			if (!distances.empty()) {
 				for (const auto& [second_stop, length_as_node] : distances) {
-					routes_lengths_[stop_name][second_stop] = length_as_node.AsInt();
+					routes_lengths_[stop_name][std::string(second_stop.AsStringView())] = length_as_node.AsInt();
 				};
 			};
 		};
 	}
 
-	void JsonReader::ParseBuses(std::vector<Dict> buses) {
-		for (const auto& object : buses) {
-			const std::string& bus_name = object.at("name"s).AsString();
+	void JsonReader::ParseBuses(const std::pmr::vector<const Dict*>& buses) {
+		for (const Dict* object_ptr : buses) {
+			const Dict& object = *object_ptr;
+			const std::string bus_name{ object.at("name"sv).AsText() };
 			auto& bus_route = parsed_buses_routes_[bus_name];
 
-			bool is_roundtrip{ object.at("is_roundtrip"s).AsBool() };
+			bool is_roundtrip{ object.at("is_roundtrip"sv).AsBool() };
 
 			//filling pair of vector and bool is_roundtrip
-			std::vector<std::string> stops;
-			bus_route = std::make_pair(stops, is_roundtrip);
+			bus_route.second = is_roundtrip;
 
 			//getting bus stops vector and converting stops names to strings
-			const std::vector<Node>& bus_stops = object.at("stops"s).AsArray();
+			const Array& bus_stops = object.at("stops"sv).AsArray();
+			//way back of not roundtrip route is not stored, catalogue views route there and back.
+			//route of bus which is given again is replaced
+			bus_route.first.clear();
+			bus_route.first.reserve(bus_stops.size());
 			for (const auto& stop : bus_stops) {
-				bus_route.first.push_back(stop.AsString());
-			};
-			//check if route is not a roundtrip and and adding stops to route in reversed order if not
-			if (!is_roundtrip) {
-				if (bus_route.first.size() == 1) {
-					bus_route.first.push_back(bus_route.first.front());
-				}
-				else {
-					for (int i = int(parsed_buses_routes_.at(bus_name).first.size()) - 2; i >= 0; --i) {
-						bus_route.first.push_back(bus_route.first[i]);
-					};
-				};
+				bus_route.first.emplace_back(stop.AsText());
 			};
 		}
 	}
@@ -7,12 +7,16 @@
 #include <string_view>
 #include <variant>
 #include <sstream>
+#include <memory>
+#include <charconv>
 
 #include "geo.h"
 #include "json.h"
-#include "json_builder.h"
+#include "answer_cache.h"
 #include "domain.h"
 #include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "thread_pool.h"
 
 namespace json {
 	using namespace std::string_literals;
@@ -23,8 +27,44 @@ namespace json {
 
 		void LoadData(std::istream&, render::MapRenderer& renderer);
 
+		void LoadData(std::string_view, render::MapRenderer& renderer);
+
+		//base requests are added to catalogue while input is parsed, document and parsed stops,
+		//lengths and buses are not built. stops can be referred by other requests before they are added.
+		//if workers are passed, base requests are parsed by them and added to catalogue in input order
+		void LoadData(std::istream&, render::MapRenderer& renderer, transport::Catalogue& catalogue,
+			parallel::ThreadPool* workers = nullptr);
+
+		void LoadData(std::string_view, render::MapRenderer& renderer, transport::Catalogue& catalogue,
+			parallel::ThreadPool* workers = nullptr);
+
+		//only stat requests are parsed, base requests and render settings are skipped by pre-scan
+		void LoadStatRequests(std::string_view);
+
 		void Print(std::ostream& out, const std::vector<objects::RequestAnswer>&);
 
+		//answers are written to stream as soon as they are passed, without building json document
+		void StartAnswers(std::ostream& out);
+
+		void PrintAnswer(const objects::RequestAnswer&);
+
+		//prints answer serialized before, with id of current request
+		void PrintAnswer(const AnswerFragment&, int id);
+
+		//prints answer text written by WriteAnswer to other writer
+		void PrintSerializedAnswer(std::string_view);
+
+		//methods below dont change reader and can be called from several threads at once
+
+		//serializes answer to the same text as PrintAnswer, position of request id is remembered
+		AnswerFragment SerializeAnswer(const objects::RequestAnswer&) const;
+
+		void WriteAnswer(Writer&, const objects::RequestAnswer&) const;
+
+		void WriteAnswer(Writer&, const AnswerFragment&, int id) const;
+
+		void FinishAnswers();
+
 		const std::map<std::string, geo::Coordinates>& GetParsedStops();
 
 		const std::vector <objects::Request>& GetParsedRequests();
@@ -33,29 +73,50 @@ namespace json {
 
 		const std::map<std::string, std::pair<std::vector<std::string>, bool>>& GetParsedBuses();
 
+		struct LoadStats {
+			Document::MemoryStats document{}; //allocations of parsed document
+			size_t walk_allocations{}; //allocations of containers which collect pointers to document objects
+		};
+
+		const LoadStats& GetLoadStats() const;
+
 	private:
+		class CatalogueLoader;
+
 		std::map<std::string, geo::Coordinates> parsed_stops_{};
 		std::map<std::string, std::pair<std::vector<std::string>, bool>> parsed_buses_routes_{};
 		std::map<std::string, std::map<std::string, int>> routes_lengths_{};
 		std::vector <objects::Request> parsed_requests{};
+		std::unique_ptr<Writer> answers_writer_{};
+		LoadStats load_stats_{};
+
+		//place of request id in serialized answer
+		struct IdPosition {
+			size_t position{};
+			size_t length{};
+		};
+
+		void ProcessStopsAndBuses(const Array&, std::pmr::memory_resource*);
+
+		void ProcessRenderSettings(render::MapRenderer& renderer, const Dict&);
 
-		void ProcessStopsAndBuses(std::vector<Node>);
+		void ProcessRequests(const Array&);
 
-		void ProcessRenderSettings(render::MapRenderer& renderer, std::map<std::string, Node>);
+		void ParseStops(const std::pmr::vector<const Dict*>&);
 
-		void ProcessRequests(std::vector<Node>);
+		void ParseBuses(const std::pmr::vector<const Dict*>&);
 
-		void ParseStops(std::vector<Dict>);
+		IdPosition WriteAnswerItems(Writer&, const objects::RequestAnswer&) const;
 
-		void ParseBuses(std::vector<Dict>);
+		IdPosition PrintRequestId(Writer&, int id) const;
 
-		void PrintStop(Builder&, const std::vector<std::string>&);
+		IdPosition PrintStop(Writer&, int id, const std::vector<std::string>&) const;
 
-		void PrintBus(Builder&, const objects::RouteData&);
+		IdPosition PrintBus(Writer&, int id, const objects::RouteData&) const;
 
-		void PrintSvgMap(Builder&, const std::string_view&);
+		IdPosition PrintSvgMap(Writer&, int id, const std::string_view&) const;
 
-		void PrintError(Builder&, const bool);
+		IdPosition PrintError(Writer&, int id, const bool) const;
 	};
 
 }//end of namespace json
\ No newline at end of file
@@ -1,19 +1,144 @@
-﻿#include <fstream>
+﻿#include <charconv>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include "transport_catalogue.h"
 #include "request_handler.h"
 #include "map_renderer.h"
+#include "input_file.h"
 
-int main()
+using namespace std::string_view_literals;
+
+namespace {
+	//more workers than this is surely a typo, every worker is a thread
+	constexpr size_t MAX_WORKERS = 1024;
+
+	//whole text must be a decimal number
+	std::optional<size_t> ParseCount(std::string_view text) {
+		size_t count{};
+		const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), count);
+		if (text.empty() || error != std::errc{} || end != text.data() + text.size()) {
+			return std::nullopt;
+		};
+		return count;
+	}
+
+	std::optional<RequestHandler::RoutesDataMode> ParseRoutesDataMode(std::string_view text) {
+		if (text == "eager"sv) { return RequestHandler::RoutesDataMode::EAGER; };
+		if (text == "on-demand"sv) { return RequestHandler::RoutesDataMode::ON_DEMAND; };
+		if (text == "background"sv) { return RequestHandler::RoutesDataMode::BACKGROUND; };
+		return std::nullopt;
+	}
+
+	std::optional<RequestHandler::LoadingMode> ParseLoadingMode(std::string_view text) {
+		if (text == "document"sv) { return RequestHandler::LoadingMode::DOCUMENT; };
+		if (text == "streaming"sv) { return RequestHandler::LoadingMode::STREAMING; };
+		if (text == "parallel"sv) { return RequestHandler::LoadingMode::PARALLEL; };
+		return std::nullopt;
+	}
+
+	void PrintUsage(const char* program) {
+		std::cerr << "Usage: " << program << " [--input <path>] [--output <path>]"
+			<< " [--load-snapshot <path>] [--save-snapshot <path>]"
+			<< " [--workers <1.." << MAX_WORKERS << ">] [--routes-data eager|on-demand|background]"
+			<< " [--loading document|streaming|parallel] [--answer-cache <entries>]" << std::endl;
+	}
+}
+
+int main(int argc, char* argv[])
 {
-	std::ifstream i_file_stream("commands.txt");
-	std::ofstream o_file_stream("result.json");
+	//paths can be changed by options, "-" means standard input or output
+	std::string input_path = "commands.txt";
+	std::string output_path = "result.json";
+	//snapshot is not used if path is empty
+	std::string load_snapshot_path;
+	std::string save_snapshot_path;
+	//processing options are applied only if they are given, otherwise handler defaults are used
+	std::string workers_option; //threads which answer requests and calculate routes data
+	std::string routes_data_option;
+	std::string loading_option;
+	std::string answer_cache_option;
+	for (int i = 1; i < argc; i += 2) {
+		const std::string_view option = argv[i];
+		std::string* value = option == "--input"sv ? &input_path
+			: option == "--output"sv ? &output_path
+			: option == "--load-snapshot"sv ? &load_snapshot_path
+			: option == "--save-snapshot"sv ? &save_snapshot_path
+			: option == "--workers"sv ? &workers_option
+			: option == "--routes-data"sv ? &routes_data_option
+			: option == "--loading"sv ? &loading_option
+			: option == "--answer-cache"sv ? &answer_cache_option
+			: nullptr;
+		if (i + 1 == argc || value == nullptr) {
+			PrintUsage(argv[0]);
+			return 1;
+		};
+		*value = argv[i + 1];
+	};
+
+	//all values are checked before any file is opened
+	const std::optional<size_t> workers_count = ParseCount(workers_option);
+	const std::optional<RequestHandler::RoutesDataMode> routes_data_mode = ParseRoutesDataMode(routes_data_option);
+	const std::optional<RequestHandler::LoadingMode> loading_mode = ParseLoadingMode(loading_option);
+	const std::optional<size_t> answer_cache_capacity = ParseCount(answer_cache_option);
+	if ((!workers_option.empty() && (!workers_count || *workers_count == 0 || *workers_count > MAX_WORKERS))
+		|| (!routes_data_option.empty() && !routes_data_mode)
+		|| (!loading_option.empty() && !loading_mode)
+		|| (!answer_cache_option.empty() && !answer_cache_capacity)) {
+		PrintUsage(argv[0]);
+		return 1;
+	};
+
+	try {
+		io::InputFile input(input_path);
+		std::ofstream o_file_stream;
+		if (output_path != "-") {
+			o_file_stream.open(output_path);
+			if (!o_file_stream) {
+				std::cerr << "Failed to open " << output_path << std::endl;
+				return 1;
+			};
+		};
+
+		//loaded catalogue keeps names in snapshot data, so file is declared before catalogue and outlives it
+		std::optional<io::InputFile> snapshot_file;
+		transport::Catalogue catalogue;
+		render::MapRenderer map_renderer;
+		RequestHandler handler(output_path == "-" ? std::cout : o_file_stream, catalogue, map_renderer);
+		if (workers_count) {
+			handler.SetWorkersCount(*workers_count);
+		};
+		if (routes_data_mode) {
+			handler.SetRoutesDataMode(*routes_data_mode);
+		};
+		if (loading_mode) {
+			handler.SetLoadingMode(*loading_mode);
+		};
+		if (answer_cache_capacity) {
+			handler.SetAnswerCacheCapacity(*answer_cache_capacity);
+		};
+		if (!load_snapshot_path.empty()) {
+			snapshot_file.emplace(load_snapshot_path);
+			handler.LoadSnapshot(snapshot_file->GetData());
+		};
+		handler.ProcessAllRequests(input);
 
-	transport::Catalogue catalogue;
-	render::MapRenderer map_renderer;
-	RequestHandler handler(i_file_stream, o_file_stream, catalogue, map_renderer);
-	handler.ProcessAllRequests();
+		if (!save_snapshot_path.empty()) {
+			std::ofstream snapshot_stream(save_snapshot_path, std::ios::binary);
+			handler.SaveSnapshot(snapshot_stream);
+			if (!snapshot_stream) {
+				std::cerr << "Failed to write " << save_snapshot_path << std::endl;
+				return 1;
+			};
+		};
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	};
 
 	return 0;
 }
\ No newline at end of file
@@ -5,23 +5,28 @@ namespace render {
 	void MapRenderer::SetWidthAndHeight(const double width, const double height) {
 		settings_.width = width;
 		settings_.height = height;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetPadding(const double padding) {
 		settings_.padding = padding;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetStopRadius(const double stop_radius) {
 		settings_.stop_radius = stop_radius;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetLineWidth(const double line_width) {
 		settings_.line_width = line_width;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetBusAndStopsFontsSize(const int bus_label_font_size, const int stop_label_font_size) {
 		settings_.bus_label_font_size = bus_label_font_size;
 		settings_.stop_label_font_size = stop_label_font_size;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetBusAndStopLabelsOffset(const double bus_offset_x, const double bus_offset_y,
@@ -30,33 +35,118 @@ namespace render {
 		settings_.bus_label_offset.y = bus_offset_y;
 		settings_.stop_label_offset.x = stop_offset_x;
 		settings_.stop_label_offset.y = stop_offset_y;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetUnderlayerColor(const svg::Color& underlayer_color) {
 		settings_.underlayer_color = underlayer_color;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetUnderlayerWidth(const double underlayer_width) {
 		settings_.underlayer_width = underlayer_width;
+		++settings_version_;
 	}
 
 	void MapRenderer::SetColorPalette(const std::vector<svg::Color> color_palette) {
 		settings_.color_palette = color_palette;
+		++settings_version_;
 	}
 
-	void MapRenderer::GetRoutes(const std::vector<const objects::Bus*>& buses) {
-		//incoming vector doesnt have duplicates and already sorted
-		buses_ = buses;
+	void MapRenderer::SaveSettings(snapshot::Writer& writer) const {
+		using snapshot::Section;
+		snapshot::RenderSettingsRecord record{};
+		record.width = settings_.width;
+		record.height = settings_.height;
+		record.padding = settings_.padding;
+		record.line_width = settings_.line_width;
+		record.stop_radius = settings_.stop_radius;
+		record.bus_label_font_size = settings_.bus_label_font_size;
+		record.stop_label_font_size = settings_.stop_label_font_size;
+		record.bus_label_offset_x = settings_.bus_label_offset.x;
+		record.bus_label_offset_y = settings_.bus_label_offset.y;
+		record.stop_label_offset_x = settings_.stop_label_offset.x;
+		record.stop_label_offset_y = settings_.stop_label_offset.y;
+		record.underlayer_color = writer.AddString(settings_.underlayer_color);
+		record.underlayer_width = settings_.underlayer_width;
+		record.palette_begin = writer.Count<snapshot::StringRef>(Section::COLORS);
+		record.palette_count = settings_.color_palette.size();
+		for (const svg::Color& color : settings_.color_palette) {
+			writer.Add(Section::COLORS, writer.AddString(color));
+		};
+		writer.Add(Section::RENDER_SETTINGS, record);
+	}
+
+	void MapRenderer::LoadSettings(const snapshot::View& view) {
+		using snapshot::Section;
+		if (view.Count<snapshot::RenderSettingsRecord>(Section::RENDER_SETTINGS) != 1) {
+			throw snapshot::SnapshotError("Snapshot doesnt have render settings");
+		};
+		const snapshot::RenderSettingsRecord record = view.Read<snapshot::RenderSettingsRecord>(Section::RENDER_SETTINGS, 0);
+		const size_t colors_count = view.Count<snapshot::StringRef>(Section::COLORS);
+		if (record.palette_begin > colors_count || record.palette_count > colors_count - record.palette_begin) {
+			throw snapshot::SnapshotError("Snapshot palette is out of colors section");
+		};
+
+		Settings settings;
+		settings.width = record.width;
+		settings.height = record.height;
+		settings.padding = record.padding;
+		settings.line_width = record.line_width;
+		settings.stop_radius = record.stop_radius;
+		settings.bus_label_font_size = record.bus_label_font_size;
+		settings.stop_label_font_size = record.stop_label_font_size;
+		settings.bus_label_offset = { record.bus_label_offset_x, record.bus_label_offset_y };
+		settings.stop_label_offset = { record.stop_label_offset_x, record.stop_label_offset_y };
+		settings.underlayer_color = svg::Color(view.GetString(record.underlayer_color));
+		settings.underlayer_width = record.underlayer_width;
+		for (size_t i = 0; i < record.palette_count; ++i) {
+			settings.color_palette.emplace_back(view.GetString(view.Read<snapshot::StringRef>(Section::COLORS, record.palette_begin + i)));
+		};
+		settings_ = std::move(settings);
+		++settings_version_;
+	}
 
-		//creating map of sorted and unique stops
-		for (const objects::Bus* bus_ptr : buses_) {
-			for (const objects::Stop* stop_ptr : bus_ptr->stops) {
-				unique_stops_points_[stop_ptr];
+	void MapRenderer::GetRoutes(const std::vector<objects::BusRoute>& routes, objects::ObjectsView<objects::Stop> stops,
+		const uint64_t routes_version) {
+		//incoming vector doesnt have duplicates and already sorted
+		routes_ = routes;
+		routes_version_ = routes_version;
+		has_routes_ = true;
+		stops_ = stops;
+
+		//creating vector of sorted and unique stops
+		std::vector<bool> is_used(stops.size());
+		unique_stops_.clear();
+		for (const objects::BusRoute& bus_route : routes_) {
+			for (const uint32_t stop_id : bus_route.route.Stops()) {
+				if (!is_used[stop_id]) {
+					is_used[stop_id] = true;
+					unique_stops_.push_back(stop_id);
+				};
 			};
 		};
+		std::sort(unique_stops_.begin(), unique_stops_.end(), [&stops](uint32_t lhs, uint32_t rhs) {
+			return stops[lhs].name < stops[rhs].name;
+			});
+		stops_points_.assign(stops.size(), svg::Point{});
+	}
+
+	bool MapRenderer::IsMapActual(const uint64_t routes_version) const {
+		return has_routes_ && routes_version_ == routes_version && rendered_
+			&& rendered_->routes_version == routes_version_ && rendered_->settings_version == settings_version_;
+	}
+
+	std::string_view MapRenderer::GetRenderedMap() const {
+		return ready_map;
 	}
 
 	const std::string_view MapRenderer::MapAsSvg() {
+		//map is rendered only once for same routes and settings, all answers refer to the same string
+		if (rendered_ && rendered_->routes_version == routes_version_ && rendered_->settings_version == settings_version_) {
+			return ready_map;
+		};
+
 		FindMinMaxCoordinates();
 		CalculateZoomCoef();
 		GetXYCoordinates();
@@ -71,14 +161,16 @@ namespace render {
 		doc.Render(stream);
 
 		ready_map = stream.str();
+		rendered_ = RenderedVersions{ routes_version_, settings_version_ };
 
 		return ready_map;
 	}
 
 	void MapRenderer::FindMinMaxCoordinates() {
-		for (const auto& [stop, _] : unique_stops_points_) {
-			const auto& longitude = stop->coordinates.lng;
-			const auto& latitude = stop->coordinates.lat;
+		min_lng = min_lat = max_lng = max_lat = 0;
+		for (const uint32_t stop_id : unique_stops_) {
+			const auto& longitude = stops_[stop_id].coordinates.lng;
+			const auto& latitude = stops_[stop_id].coordinates.lat;
 			if (min_lng == 0 || longitude < min_lng) { min_lng = longitude; };
 			if (min_lat == 0 || latitude < min_lat) { min_lat = latitude; };
 			if (max_lng == 0 || longitude > max_lng) { max_lng = longitude; };
@@ -98,9 +190,9 @@ namespace render {
 	}
 
 	void MapRenderer::GetXYCoordinates() {
-		for (auto& [stop_ptr, point] : unique_stops_points_) { //converting lng & lat to x & y
-			svg::Point point_xy(GetX(stop_ptr->coordinates.lng), GetY(stop_ptr->coordinates.lat));
-			point = point_xy;
+		for (const uint32_t stop_id : unique_stops_) { //converting lng & lat to x & y
+			const geo::Coordinates& coordinates = stops_[stop_id].coordinates;
+			stops_points_[stop_id] = svg::Point(GetX(coordinates.lng), GetY(coordinates.lat));
 		};
 	}
 
@@ -114,16 +206,16 @@ namespace render {
 
 	void MapRenderer::AddPolylines(svg::Document& doc) {
 		int color{}; //color palette index 
-		for (const auto& bus_ptr : buses_) {
-			if (!bus_ptr->stops.empty()) {  //if current route has zero stops skip it
+		for (const auto& [bus_ptr, route] : routes_) {
+			if (!route.empty()) {  //if current route has zero stops skip it
 
 				svg::Polyline polyline; //create polyline object and setting its properties
 				polyline.SetStrokeColor(settings_.color_palette[color]).SetFillColor(svg::NoneColor).
 					SetStrokeWidth(settings_.line_width).SetStrokeLineCap(svg::StrokeLineCap::ROUND).
 					SetStrokeLineJoin(svg::StrokeLineJoin::ROUND);
 
-				for (const auto& stop_ptr : bus_ptr->stops) { //adding all points from one bus route
-					polyline.AddPoint(unique_stops_points_.at(stop_ptr));
+				for (const uint32_t stop_id : route) { //adding all points from one bus route, there and back
+					polyline.AddPoint(stops_points_[stop_id]);
 				};
 				doc.Add(polyline); //adding ready polyline to doc
 
@@ -135,16 +227,16 @@ namespace render {
 
 	void MapRenderer::AddRoutesNames(svg::Document& doc) {
 		int color{}; //color palette index 
-		for (const auto& bus_ptr : buses_) {
-			if (!bus_ptr->stops.empty()) {  //if current route has zero stops skip it
-				const auto& first_stop_ptr = bus_ptr->stops.front();
-				const svg::Point& first_stop_xy = unique_stops_points_.at(first_stop_ptr);
+		for (const auto& [bus_ptr, route] : routes_) {
+			if (!route.empty()) {  //if current route has zero stops skip it
+				const uint32_t first_stop_id = route[0];
+				const svg::Point& first_stop_xy = stops_points_[first_stop_id];
 
 				//create text object and setting its properties
 				svg::Text text;
 				text.SetFontSize(settings_.bus_label_font_size).SetFillColor(settings_.color_palette[color]).
 					SetFontFamily("Verdana"s).SetFontWeight("bold"s).SetPosition(first_stop_xy).
-					SetOffset(settings_.bus_label_offset).SetData(bus_ptr->name);
+					SetOffset(settings_.bus_label_offset).SetData(std::string(bus_ptr->name));
 				//create underlayer object and setting its properties
 				svg::Text underlayer(text);
 				underlayer.SetFillColor(settings_.underlayer_color).SetStrokeColor(settings_.underlayer_color).
@@ -155,11 +247,10 @@ namespace render {
 				doc.Add(text);
 
 				if (bus_ptr->is_roundtrip == false) { //if not a roundtrip, add same objects for the last stop
-					//not a roundtrip route always will have odd number of stops, 
-					//so last stop will have index .size()/2
-					const auto& last_stop_ptr = bus_ptr->stops.at(bus_ptr->stops.size() / 2);
-					const svg::Point& last_stop_xy = unique_stops_points_.at(last_stop_ptr);
-					if (first_stop_ptr != last_stop_ptr) { //stops must be different
+					//only the way there is stored, so its last stop is the end of route
+					const uint32_t last_stop_id = route[route.Stops().size() - 1];
+					const svg::Point& last_stop_xy = stops_points_[last_stop_id];
+					if (first_stop_id != last_stop_id) { //stops must be different
 						underlayer.SetPosition(last_stop_xy);
 						text.SetPosition(last_stop_xy);
 						doc.Add(underlayer); //add objects for the last stop of the route
@@ -174,20 +265,20 @@ namespace render {
 	}
 
 	void MapRenderer::AddStopsCircles(svg::Document& doc) {
-		for (const auto& [_, point] : unique_stops_points_) {
+		for (const uint32_t stop_id : unique_stops_) {
 			svg::Circle circle;
-			circle.SetCenter(point).SetRadius(settings_.stop_radius).SetFillColor("white"s);
+			circle.SetCenter(stops_points_[stop_id]).SetRadius(settings_.stop_radius).SetFillColor("white"s);
 			doc.Add(circle);
 		};
 	}
 
 	void MapRenderer::AddStopsNames(svg::Document& doc) {
-		for (const auto& [stop_ptr, point] : unique_stops_points_) {
+		for (const uint32_t stop_id : unique_stops_) {
 
 			//create text object and setting its properties
 			svg::Text text;
 			text.SetFontSize(settings_.stop_label_font_size).SetFillColor("black"s).SetFontFamily("Verdana"s).
-				SetPosition(point).SetOffset(settings_.stop_label_offset).SetData(stop_ptr->name);
+				SetPosition(stops_points_[stop_id]).SetOffset(settings_.stop_label_offset).SetData(std::string(stops_[stop_id].name));
 			//create underlayer object and setting its properties
 			svg::Text underlayer(text);
 			underlayer.SetFillColor(settings_.underlayer_color).SetStrokeColor(settings_.underlayer_color).
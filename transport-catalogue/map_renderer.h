@@ -8,9 +8,11 @@
 #include <set>
 #include <algorithm>
 #include <cmath>
+#include <optional>
 
 #include "svg.h"
 #include "domain.h"
+#include "snapshot.h"
 
 using namespace std::string_literals;
 
@@ -39,10 +41,23 @@ namespace render {
 
 		void SetColorPalette(const std::vector<svg::Color> color_palette);
 
-		void GetRoutes(const std::vector<const objects::Bus*>&);
+		//routes must be sorted by buses names, stops are all catalogue stops indexed by ids,
+		//version identifies state of catalogue data which routes are taken from
+		void GetRoutes(const std::vector<objects::BusRoute>&, objects::ObjectsView<objects::Stop>, const uint64_t routes_version);
 
+		//true if map is already rendered for routes of this version and for current settings
+		bool IsMapActual(const uint64_t routes_version) const;
+
+		//renders map only if routes or settings were changed after last render
 		const std::string_view MapAsSvg();
 
+		//map made by last MapAsSvg call, doesnt render anything
+		std::string_view GetRenderedMap() const;
+
+		void SaveSettings(snapshot::Writer&) const;
+
+		void LoadSettings(const snapshot::View&);
+
 	private:
 		struct Settings {
 			double height{}, width{}, padding{};
@@ -56,10 +71,22 @@ namespace render {
 
 		Settings settings_;
 
-		std::vector<const objects::Bus*> buses_;
-		std::map<const objects::Stop*, svg::Point, objects::StopPtrComp> unique_stops_points_;
+		std::vector<objects::BusRoute> routes_;
+		objects::ObjectsView<objects::Stop> stops_;
+		std::vector<uint32_t> unique_stops_; //ids of stops with buses, sorted by names
+		std::vector<svg::Point> stops_points_; //points of stops indexed by stops ids
 		std::string ready_map;
 
+		struct RenderedVersions {
+			uint64_t routes_version{};
+			uint64_t settings_version{};
+		};
+
+		uint64_t settings_version_{}; //incremented by every setter
+		uint64_t routes_version_{};
+		bool has_routes_ = false;
+		std::optional<RenderedVersions> rendered_; //versions of ready map
+
 		double min_lng{}, min_lat{};
 		double max_lng{}, max_lat{};
 		double zoom_coef_;
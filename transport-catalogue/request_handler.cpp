@@ -2,8 +2,55 @@
 
 void RequestHandler::ProcessAllRequests() {
 	json::JsonReader reader;
-	reader.LoadData(input, renderer_);
+	LoadRequests(json::ReadAll(input), reader);
+	AnswerRequests(reader);
+}
+
+void RequestHandler::ProcessAllRequests(io::InputFile& input_file) {
+	json::JsonReader reader;
+	LoadRequests(input_file.GetData(), reader);
+	//catalogue, renderer and reader keep copies of all loaded data, so input is not needed while answering
+	input_file.Release();
+	AnswerRequests(reader);
+}
+
+void RequestHandler::LoadRequests(std::string_view input_data, json::JsonReader& reader) {
+	if (snapshot_loaded_) {
+		reader.LoadStatRequests(input_data);
+	}
+	else if (loading_mode_ == LoadingMode::STREAMING) {
+		reader.LoadData(input_data, renderer_, db_);
+	}
+	else if (loading_mode_ == LoadingMode::PARALLEL) {
+		reader.LoadData(input_data, renderer_, db_, workers_.get());
+	}
+	else {
+		reader.LoadData(input_data, renderer_);
+		AddParsedBaseRequests(reader);
+	};
+}
+
+void RequestHandler::AnswerRequests(json::JsonReader& reader) {
+	//adding route data for buses, now or when it is requested. catalogue from snapshot has it already
+	if (!snapshot_loaded_) {
+		if (routes_data_mode_ == RoutesDataMode::EAGER) {
+			db_.CalculateRoutesData(workers_.get());
+		}
+		else {
+			db_.PrepareRoutesDataOnDemand(routes_data_mode_ == RoutesDataMode::BACKGROUND);
+		};
+	};
+
+	//vector of parsed requests
+	const auto& requests = reader.GetParsedRequests();
 
+	//constructing and printing answers for each request
+	reader.StartAnswers(output);
+	ProcessParsedStatRequests(requests, reader);
+	reader.FinishAnswers();
+}
+
+void RequestHandler::AddParsedBaseRequests(json::JsonReader& reader) {
 	//adding bus stops to catalogue
 	for (const auto& [name, coordinates] : reader.GetParsedStops()) {
 		db_.AddStop(name, coordinates);
@@ -28,39 +75,144 @@ void RequestHandler::ProcessAllRequests() {
 			//db_.AddBusForStop(stop_ptr, bus_ptr);
 		};
 	};
+}
 
-	//adding route data for buses
-	db_.CalculateRoutesData();
+void RequestHandler::ProcessParsedStatRequests(const std::vector<Request>& requests, json::JsonReader& reader) {
+	//map is rendered before answering, so answers only read it
+	const bool has_map_requests = std::any_of(requests.begin(), requests.end(),
+		[](const Request& request) { return request.type == "Map"s; });
+	if (has_map_requests) {
+		//routes are passed to renderer only if catalogue was changed since last render
+		if (!renderer_.IsMapActual(db_.GetVersion())) {
+			renderer_.GetRoutes(db_.RoutesForMap(), db_.GetStops(), db_.GetVersion());
+		};
+		renderer_.MapAsSvg();
+	};
 
-	//vector of parsed requests
-	const auto& requests = reader.GetParsedRequests();
-	//vector of answers for requests
-	std::vector<RequestAnswer> answers;
-	
-	//constructing answers for each request
-	ProcessParsedStatRequests(requests, answers);
-
-	//printing
-	reader.Print(output, answers);
-}
+	//cached answers are dropped if catalogue was changed after they were made
+	if (answers_version_ != db_.GetVersion()) {
+		answers_cache_.Clear();
+		answers_version_ = db_.GetVersion();
+	};
+
+	if (workers_) {
+		ProcessStatRequestsInParallel(requests, reader);
+		return;
+	};
 
-void RequestHandler::ProcessParsedStatRequests(const std::vector<Request>& requests, std::vector<RequestAnswer>& answers) {
-	//temporary unordered map to save results, in order not to search again for the same requests
-	//using request id as a map key
-	std::unordered_map<int, RequestAnswer> temp_answers;
 	for (const auto& request : requests) {
-		//construct answer only if request hasnt been already processed
-		if (temp_answers.count(request.id) == 0) {
-			if (request.type == "Map"s) {
-				temp_answers[request.id].id = request.id;
-				renderer_.GetRoutes(db_.RoutesForMap());
-				temp_answers[request.id].data = renderer_.MapAsSvg();
+		if (request.type == "Map"s) {
+			reader.PrintAnswer(MapAnswer(request));
+		}
+		else if (!answers_cache_.Find(request.type, request.name,
+			[&](const json::AnswerFragment& cached) { reader.PrintAnswer(cached, request.id); })) {
+			json::AnswerFragment fragment = reader.SerializeAnswer(db_.ConstructAnswerForRequest(request));
+			reader.PrintAnswer(fragment, request.id);
+			answers_cache_.Insert(request.type, request.name, std::move(fragment));
+		};
+	};
+}
+
+void RequestHandler::ProcessStatRequestsInParallel(const std::vector<Request>& requests, json::JsonReader& reader) {
+	//answers of every chunk are written to its own buffer, ends are positions after every answer in buffer
+	struct ChunkAnswers {
+		std::string text;
+		std::vector<size_t> ends;
+	};
+	const size_t window_chunks = workers_->GetThreadsCount() * CHUNKS_PER_WORKER;
+	std::vector<ChunkAnswers> chunks(window_chunks);
+
+	for (size_t window = 0; window < requests.size(); window += window_chunks * REQUESTS_CHUNK) {
+		const size_t window_size = std::min(window_chunks * REQUESTS_CHUNK, requests.size() - window);
+
+		workers_->ParallelFor(window_size, REQUESTS_CHUNK, [&](size_t begin, size_t end) {
+			ChunkAnswers& chunk = chunks[begin / REQUESTS_CHUNK];
+			chunk.ends.clear();
+			std::ostringstream stream;
+			{
+				json::Writer writer(stream);
+				for (size_t i = window + begin; i < window + end; ++i) {
+					//map is big, so it is printed later straight from renderer
+					if (requests[i].type != "Map"s) {
+						WriteAnswer(requests[i], reader, writer);
+					};
+					chunk.ends.push_back(writer.Position());
+				};
 			}
-			else {
-				temp_answers[request.id] = db_.ConstructAnswerForRequest(request);
+			chunk.text = stream.str();
+		});
+
+		//printing answers of window in requests order
+		size_t request_index = window;
+		for (size_t chunk_index = 0; chunk_index * REQUESTS_CHUNK < window_size; ++chunk_index) {
+			const std::string_view text = chunks[chunk_index].text;
+			size_t start = 0;
+			for (const size_t end : chunks[chunk_index].ends) {
+				const Request& request = requests[request_index++];
+				if (request.type == "Map"s) {
+					reader.PrintAnswer(MapAnswer(request));
+				}
+				else {
+					reader.PrintSerializedAnswer(text.substr(start, end - start));
+				};
+				start = end;
 			};
 		};
-		//creating object for each request in answers vector
-		answers.push_back(temp_answers.at(request.id));
 	};
+}
+
+void RequestHandler::WriteAnswer(const Request& request, const json::JsonReader& reader, json::Writer& writer) {
+	if (answers_cache_.Find(request.type, request.name,
+		[&](const json::AnswerFragment& cached) { reader.WriteAnswer(writer, cached, request.id); })) {
+		return;
+	};
+	json::AnswerFragment fragment = reader.SerializeAnswer(db_.ConstructAnswerForRequest(request));
+	reader.WriteAnswer(writer, fragment, request.id);
+	answers_cache_.Insert(request.type, request.name, std::move(fragment));
+}
+
+RequestAnswer RequestHandler::MapAnswer(const Request& request) const {
+	RequestAnswer answer;
+	answer.id = request.id;
+	answer.data = renderer_.GetRenderedMap();
+	return answer;
+}
+
+void RequestHandler::SetAnswerCacheCapacity(size_t capacity) {
+	answers_cache_.SetCapacity(capacity);
+}
+
+json::AnswerCache::Stats RequestHandler::GetAnswerCacheStats() const {
+	return answers_cache_.GetStats();
+}
+
+void RequestHandler::SetWorkersCount(size_t count) {
+	if (count <= 1) {
+		workers_.reset();
+	}
+	else {
+		workers_ = std::make_unique<parallel::ThreadPool>(count);
+	};
+}
+
+void RequestHandler::SetRoutesDataMode(RoutesDataMode mode) {
+	routes_data_mode_ = mode;
+}
+
+void RequestHandler::SetLoadingMode(LoadingMode mode) {
+	loading_mode_ = mode;
+}
+
+void RequestHandler::LoadSnapshot(std::string_view data) {
+	const snapshot::View view(data);
+	db_.Load(view);
+	renderer_.LoadSettings(view);
+	snapshot_loaded_ = true;
+}
+
+void RequestHandler::SaveSnapshot(std::ostream& out) const {
+	snapshot::Writer writer;
+	db_.Save(writer);
+	renderer_.SaveSettings(writer);
+	writer.Write(out);
 }
\ No newline at end of file
@@ -1,9 +1,13 @@
 #pragma once
 #include <iostream>
+#include <memory>
 
 #include "transport_catalogue.h"
 #include "json_reader.h"
 #include "map_renderer.h"
+#include "answer_cache.h"
+#include "thread_pool.h"
+#include "input_file.h"
 
 class RequestHandler {
 public:
@@ -16,13 +20,78 @@ public:
 		: db_(db), renderer_(renderer), input(in), output(out) {
 	}
 
+	//input is passed to ProcessAllRequests
+	RequestHandler(std::ostream& out, transport::Catalogue& db, render::MapRenderer& renderer)
+		: db_(db), renderer_(renderer), output(out) {
+	}
+
 	void ProcessAllRequests();
 
-	void ProcessParsedStatRequests(const std::vector<Request>&, std::vector<RequestAnswer>&);
+	//input file is released as soon as it is loaded
+	void ProcessAllRequests(io::InputFile&);
+
+	//every answer is printed by reader as soon as it is constructed
+	void ProcessParsedStatRequests(const std::vector<Request>&, json::JsonReader&);
+
+	//answers for same objects are serialized once and kept in bounded cache,
+	//capacity 0 disables caching
+	void SetAnswerCacheCapacity(size_t capacity);
+
+	json::AnswerCache::Stats GetAnswerCacheStats() const;
+
+	//routes data is calculated and stat requests are answered by several threads if count is more than 1,
+	//answers are printed in requests order anyway
+	void SetWorkersCount(size_t count);
+
+	enum class RoutesDataMode {
+		EAGER, //data of all buses is calculated before answering
+		ON_DEMAND, //data of bus is calculated by first request about it
+		BACKGROUND, //as ON_DEMAND, but data of all buses is calculated by background thread meanwhile
+	};
+
+	void SetRoutesDataMode(RoutesDataMode mode);
+
+	enum class LoadingMode {
+		DOCUMENT, //input is parsed to document, base requests are collected by reader and then added to catalogue
+		STREAMING, //base requests are added to catalogue while input is parsed
+		PARALLEL, //as STREAMING, but base requests are parsed by workers, catalogue is the same
+	};
+
+	void SetLoadingMode(LoadingMode mode);
+
+	//catalogue and render settings are taken from snapshot, so only stat requests of input are parsed
+	//and routes data is not calculated again. names are not copied, so data must outlive catalogue
+	void LoadSnapshot(std::string_view data);
+
+	//writes catalogue with routes data and render settings, valid after requests are processed
+	void SaveSnapshot(std::ostream&) const;
 
 private:
 	transport::Catalogue& db_;
 	render::MapRenderer& renderer_;
 	std::istream& input = std::cin;
 	std::ostream& output = std::cout;
+	json::SharedAnswerCache answers_cache_{}; //cache is shared by workers
+	uint64_t answers_version_{}; //catalogue version which cached answers belong to
+	std::unique_ptr<parallel::ThreadPool> workers_{};
+	RoutesDataMode routes_data_mode_ = RoutesDataMode::EAGER;
+	LoadingMode loading_mode_ = LoadingMode::STREAMING;
+	bool snapshot_loaded_ = false;
+
+	//requests are given to workers by chunks, answers of chunks are printed by windows of several chunks per worker
+	static constexpr size_t REQUESTS_CHUNK = 64;
+	static constexpr size_t CHUNKS_PER_WORKER = 8;
+
+	void LoadRequests(std::string_view input_data, json::JsonReader&);
+
+	void AnswerRequests(json::JsonReader&);
+
+	void AddParsedBaseRequests(json::JsonReader&);
+
+	void ProcessStatRequestsInParallel(const std::vector<Request>&, json::JsonReader&);
+
+	//writes answer for bus or stop using cache, can be called from several threads at once
+	void WriteAnswer(const Request&, const json::JsonReader&, json::Writer&);
+
+	RequestAnswer MapAnswer(const Request&) const;
 };
\ No newline at end of file
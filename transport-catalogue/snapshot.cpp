@@ -0,0 +1,74 @@
+#include "snapshot.h"
+
+namespace snapshot {
+
+	using namespace std::string_literals;
+
+	namespace {
+		size_t AlignUp(size_t size) {
+			return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+		}
+	} //end of anonymous namespace
+
+	StringRef Writer::AddString(std::string_view text) {
+		std::string& strings = sections_[static_cast<size_t>(Section::STRINGS)];
+		const StringRef ref{ strings.size(), text.size() };
+		strings.append(text);
+		return ref;
+	}
+
+	void Writer::Write(std::ostream& output) const {
+		Header header{};
+		std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+		header.byte_order = BYTE_ORDER_MARK;
+		header.version = FORMAT_VERSION;
+		size_t offset = AlignUp(sizeof(Header));
+		for (size_t i = 0; i < static_cast<size_t>(Section::COUNT); ++i) {
+			header.sections[i].offset = offset;
+			header.sections[i].size = sections_[i].size();
+			offset = AlignUp(offset + sections_[i].size());
+		};
+		header.file_size = offset;
+
+		const char padding[SECTION_ALIGNMENT]{};
+		output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		output.write(padding, static_cast<std::streamsize>(AlignUp(sizeof(Header)) - sizeof(Header)));
+		for (const std::string& section : sections_) {
+			output.write(section.data(), static_cast<std::streamsize>(section.size()));
+			output.write(padding, static_cast<std::streamsize>(AlignUp(section.size()) - section.size()));
+		};
+	}
+
+	View::View(std::string_view data) : data_(data) {
+		if (data.size() < sizeof(Header)) {
+			throw SnapshotError("Input is not a catalogue snapshot"s);
+		};
+		std::memcpy(&header_, data.data(), sizeof(Header));
+		if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+			throw SnapshotError("Input is not a catalogue snapshot"s);
+		};
+		if (header_.byte_order != BYTE_ORDER_MARK) {
+			throw SnapshotError("Snapshot is made on machine with other byte order"s);
+		};
+		if (header_.version != FORMAT_VERSION) {
+			throw SnapshotError("Snapshot version "s + std::to_string(header_.version) + " is not supported"s);
+		};
+		if (header_.file_size != data.size()) {
+			throw SnapshotError("Snapshot is truncated"s);
+		};
+		for (const SectionEntry& section : header_.sections) {
+			if (section.offset % SECTION_ALIGNMENT != 0 || section.offset > data.size() || section.size > data.size() - section.offset) {
+				throw SnapshotError("Snapshot section is out of file"s);
+			};
+		};
+	}
+
+	std::string_view View::GetString(const StringRef& ref) const {
+		const SectionEntry& strings = header_.sections[static_cast<size_t>(Section::STRINGS)];
+		if (ref.offset > strings.size || ref.length > strings.size - ref.offset) {
+			throw SnapshotError("Snapshot string is out of strings section"s);
+		};
+		return data_.substr(static_cast<size_t>(strings.offset + ref.offset), static_cast<size_t>(ref.length));
+	}
+
+}//end of namespace snapshot
\ No newline at end of file
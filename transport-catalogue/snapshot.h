@@ -0,0 +1,215 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace snapshot {
+
+	//binary snapshot of built catalogue and render settings. file starts with header which keeps offsets
+	//of sections from file begin, every section is an array of plain records. records refer to other records
+	//by indexes and to strings by offsets in strings section, so snapshot has no pointers. records are made
+	//of fixed size numbers only and their layout is checked at compile time, so it doesnt depend on compiler
+	//or on layout of catalogue objects. numbers are stored in byte order of machine which made snapshot
+
+	constexpr uint32_t FORMAT_VERSION = 3;
+
+	enum class Section : uint32_t {
+		STRINGS, //chars of all names and colors
+		STOPS, //StopRecord, indexed by stops ids
+		BUSES, //BusRecord, indexed by buses ids
+		STOPS_BY_NAME, //uint32_t stops ids sorted by names, stops are found by binary search
+		BUSES_BY_NAME, //uint32_t buses ids sorted by names
+		ROUTES_STOPS, //uint32_t stops ids of all routes, way back of not roundtrip route is not stored
+		ROUTES_EDGES, //uint32_t edges ids of all routes
+		EDGES, //EdgeRecord sorted by first stop
+		STOPS_EDGES_OFFSETS, //uint32_t, edges from stop i are [offsets[i], offsets[i + 1])
+		STOPS_BUSES_OFFSETS, //uint32_t, buses of stop i are [offsets[i], offsets[i + 1]) of STOPS_BUSES
+		STOPS_BUSES, //uint32_t buses ids sorted by names
+		DISTANCES, //DistanceRecord, slots of distances hash table as they are placed in it
+		RENDER_SETTINGS, //one RenderSettingsRecord
+		COLORS, //StringRef of palette colors
+		COUNT,
+	};
+
+	struct SectionEntry {
+		uint64_t offset{}; //bytes from file begin, multiple of SECTION_ALIGNMENT
+		uint64_t size{}; //bytes
+	};
+
+	struct Header {
+		char magic[8]{};
+		uint32_t byte_order{}; //BYTE_ORDER_MARK as it is written by machine which made snapshot
+		uint32_t version{};
+		uint64_t file_size{};
+		SectionEntry sections[static_cast<size_t>(Section::COUNT)]{};
+	};
+
+	constexpr char MAGIC[8] = { 'T', 'C', 'S', 'N', 'A', 'P', '\0', '\0' };
+	constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+	constexpr size_t SECTION_ALIGNMENT = 8;
+
+	struct StringRef {
+		uint64_t offset{}; //in strings section
+		uint64_t length{};
+	};
+
+	struct StopRecord {
+		StringRef name{};
+		double lat{};
+		double lng{};
+		double sin_lat{};
+		double cos_lat{};
+	};
+
+	struct BusRecord {
+		StringRef name{};
+		uint32_t stops_begin{}; //index of first stop in ROUTES_STOPS
+		uint32_t stops_count{};
+		uint32_t edges_begin{}; //index of first edge in ROUTES_EDGES
+		uint32_t edges_count{};
+		//calculated route data
+		uint64_t unique_stops{};
+		uint64_t route_stops_count{};
+		uint64_t length{};
+		double curvature{};
+		uint32_t is_roundtrip{}; //0 or 1
+		uint32_t reserved{};
+	};
+
+	struct EdgeRecord {
+		uint32_t from{};
+		uint32_t to{};
+		uint64_t road_length{};
+		double geo_length{};
+	};
+
+	//empty slot has EMPTY_KEY of distances table
+	struct DistanceRecord {
+		uint64_t key{};
+		uint64_t length{};
+	};
+
+	struct RenderSettingsRecord {
+		double width{};
+		double height{};
+		double padding{};
+		double line_width{};
+		double stop_radius{};
+		int32_t bus_label_font_size{};
+		int32_t stop_label_font_size{};
+		double bus_label_offset_x{};
+		double bus_label_offset_y{};
+		double stop_label_offset_x{};
+		double stop_label_offset_y{};
+		StringRef underlayer_color{};
+		double underlayer_width{};
+		uint64_t palette_begin{}; //index of first color in COLORS
+		uint64_t palette_count{};
+	};
+
+	//records have no padding, so snapshot made by any compiler has the same bytes
+	static_assert(std::numeric_limits<double>::is_iec559 && sizeof(double) == 8);
+	static_assert(sizeof(Header) == 24 + 16 * static_cast<size_t>(Section::COUNT) && offsetof(Header, sections) == 24);
+	static_assert(sizeof(StringRef) == 16 && offsetof(StringRef, length) == 8);
+	static_assert(sizeof(StopRecord) == 48 && offsetof(StopRecord, lat) == 16 && offsetof(StopRecord, cos_lat) == 40);
+	static_assert(sizeof(BusRecord) == 72 && offsetof(BusRecord, stops_begin) == 16 && offsetof(BusRecord, unique_stops) == 32
+		&& offsetof(BusRecord, curvature) == 56 && offsetof(BusRecord, is_roundtrip) == 64);
+	static_assert(sizeof(EdgeRecord) == 24 && offsetof(EdgeRecord, to) == 4 && offsetof(EdgeRecord, road_length) == 8
+		&& offsetof(EdgeRecord, geo_length) == 16);
+	static_assert(sizeof(DistanceRecord) == 16 && offsetof(DistanceRecord, length) == 8);
+	static_assert(sizeof(RenderSettingsRecord) == 120 && offsetof(RenderSettingsRecord, bus_label_font_size) == 40
+		&& offsetof(RenderSettingsRecord, bus_label_offset_x) == 48 && offsetof(RenderSettingsRecord, underlayer_color) == 80
+		&& offsetof(RenderSettingsRecord, palette_count) == 112);
+
+	class SnapshotError : public std::runtime_error {
+	public:
+		using runtime_error::runtime_error;
+	};
+
+	//collects records of sections and writes them after header
+	class Writer {
+	public:
+		StringRef AddString(std::string_view text);
+
+		template <typename Record>
+		void Add(Section section, const Record& record) {
+			Add(section, &record, 1);
+		}
+
+		template <typename Record>
+		void Add(Section section, const Record* records, size_t count) {
+			static_assert(std::is_trivially_copyable_v<Record>);
+			std::string& data = sections_[static_cast<size_t>(section)];
+			const size_t size = data.size();
+			data.resize(size + sizeof(Record) * count);
+			if (count != 0) {
+				std::memcpy(data.data() + size, records, sizeof(Record) * count);
+			};
+		}
+
+		//count of records added to section
+		template <typename Record>
+		size_t Count(Section section) const {
+			return sections_[static_cast<size_t>(section)].size() / sizeof(Record);
+		}
+
+		void Write(std::ostream& output) const;
+
+	private:
+		std::string sections_[static_cast<size_t>(Section::COUNT)]{};
+	};
+
+	//snapshot placed in memory. header and borders of sections are checked on construction,
+	//indexes in records are checked by their users. records are copied out of bytes of snapshot,
+	//so they are never read from memory where no object of their type was created
+	class View {
+	public:
+		explicit View(std::string_view data);
+
+		template <typename Record>
+		size_t Count(Section section) const {
+			const uint64_t size = header_.sections[static_cast<size_t>(section)].size;
+			if (size % sizeof(Record) != 0) {
+				throw SnapshotError("Snapshot section has wrong size");
+			};
+			return static_cast<size_t>(size / sizeof(Record));
+		}
+
+		//index must be less than Count
+		template <typename Record>
+		Record Read(Section section, size_t index) const {
+			static_assert(std::is_trivially_copyable_v<Record>);
+			Record record;
+			std::memcpy(&record, data_.data() + header_.sections[static_cast<size_t>(section)].offset + index * sizeof(Record),
+				sizeof(Record));
+			return record;
+		}
+
+		//all records of section at once, arrays of ids are copied by one memcpy
+		template <typename Record>
+		std::vector<Record> ReadAll(Section section) const {
+			static_assert(std::is_trivially_copyable_v<Record>);
+			std::vector<Record> records(Count<Record>(section));
+			if (!records.empty()) {
+				std::memcpy(records.data(), data_.data() + header_.sections[static_cast<size_t>(section)].offset,
+					records.size() * sizeof(Record));
+			};
+			return records;
+		}
+
+		//view to chars of snapshot, they are valid while snapshot data is
+		std::string_view GetString(const StringRef& ref) const;
+
+	private:
+		std::string_view data_;
+		Header header_{};
+	};
+
+}//end of namespace snapshot
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../geo.h"
+
+//every supported kernel must give the same distances as scalar one within documented error,
+//count is not multiple of vector width, so rest of batch is checked too
+namespace {
+	const std::vector<std::pair<geo::DistancesKernel, std::string>> KERNELS = {
+		{ geo::DistancesKernel::SCALAR, "SCALAR" },
+		{ geo::DistancesKernel::SSE2, "SSE2" },
+		{ geo::DistancesKernel::AVX2, "AVX2" },
+	};
+
+	//random points all over the earth and around one city, some pairs are the same point
+	void AddPoints(geo::PointsBuffer& from, geo::PointsBuffer& to, size_t count) {
+		std::mt19937_64 generator(42);
+		std::uniform_real_distribution<double> lat(-90, 90);
+		std::uniform_real_distribution<double> lng(-180, 180);
+		std::uniform_real_distribution<double> near(-0.05, 0.05);
+		for (size_t i = 0; i < count; ++i) {
+			const geo::Coordinates point = i % 2 == 0 ? geo::Coordinates{ lat(generator), lng(generator) }
+				: geo::Coordinates{ 43.58 + near(generator), 39.72 + near(generator) };
+			const geo::Coordinates other = i % 7 == 0 ? point : i % 2 == 0 ? geo::Coordinates{ lat(generator), lng(generator) }
+				: geo::Coordinates{ 43.58 + near(generator), 39.72 + near(generator) };
+			from.Add(geo::PreparedCoordinates(point));
+			to.Add(geo::PreparedCoordinates(other));
+		};
+	}
+}
+
+int main() {
+	int failed = 0;
+	const size_t count = 1003;
+	geo::PointsBuffer from;
+	geo::PointsBuffer to;
+	AddPoints(from, to, count);
+
+	std::vector<double> expected(count);
+	geo::ComputeDistances(geo::DistancesKernel::SCALAR, from.Arrays(), to.Arrays(), count, expected.data());
+	for (size_t i = 0; i < count; ++i) {
+		const geo::PreparedCoordinates point({ from.Arrays().lat[i], from.Arrays().lng[i] });
+		const geo::PreparedCoordinates other({ to.Arrays().lat[i], to.Arrays().lng[i] });
+		if (expected[i] != geo::ComputeDistance(point, other)) {
+			std::cerr << "SCALAR kernel differs from ComputeDistance at " << i << std::endl;
+			++failed;
+			break;
+		};
+	};
+
+	for (const auto& [kernel, name] : KERNELS) {
+		if (!geo::IsKernelSupported(kernel)) {
+			std::cerr << name << " kernel is not supported, skipped" << std::endl;
+			continue;
+		};
+		std::vector<double> distances(count);
+		geo::ComputeDistances(kernel, from.Arrays(), to.Arrays(), count, distances.data());
+		double max_error = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const double d = expected[i];
+			const double error = std::abs(distances[i] - d);
+			max_error = std::max(max_error, error);
+			if (std::isnan(distances[i]) || (d == 0 ? distances[i] != 0 : error > 1e-9 * d + 0.02 / d)) {
+				std::cerr << std::setprecision(12) << name << " kernel gives " << distances[i] << " instead of " << d << " at " << i << std::endl;
+				++failed;
+				break;
+			};
+		};
+		std::cerr << name << " kernel max error: " << max_error << " m" << std::endl;
+	};
+
+	if (geo::IsKernelSupported(geo::GetBestKernel()) == false) {
+		std::cerr << "Best kernel is not supported" << std::endl;
+		++failed;
+	};
+
+	if (failed == 0) {
+		std::cerr << "Distances kernels test OK" << std::endl;
+	};
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,217 @@
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "../request_handler.h"
+
+using namespace std::string_literals;
+
+//stops and buses given several times must give the same catalogue in all loading modes,
+//the same as input where every name is given once with last coordinates and route and merged distances
+namespace {
+	struct StopRequest {
+		std::string name;
+		double lat{};
+		double lng{};
+		std::map<std::string, int> distances;
+	};
+
+	struct BusRequest {
+		std::string name;
+		bool is_roundtrip{};
+		std::vector<std::string> stops;
+	};
+
+	using BaseRequest = std::variant<StopRequest, BusRequest>;
+
+	//stops count is more than one window of parallel loading, so objects are given again in other window too
+	constexpr int STOPS_COUNT = 6000;
+	constexpr int BUSES_COUNT = 50;
+
+	std::string StopName(int i) {
+		return "Stop "s + std::to_string(i);
+	}
+
+	StopRequest MakeStop(int i) {
+		StopRequest stop{ StopName(i), 43.5 + (i % 100) * 0.001, 39.7 + (i / 100) * 0.001, {} };
+		if (i + 1 < STOPS_COUNT) {
+			stop.distances[StopName(i + 1)] = 1000 + i % 7 * 100;
+		};
+		return stop;
+	}
+
+	BusRequest MakeBus(int i) {
+		BusRequest bus{ "Bus "s + std::to_string(i), i % 2 == 0, {} };
+		for (int j = 0; j < 5; ++j) {
+			bus.stops.push_back(StopName(i * 100 + j * 3));
+		};
+		if (bus.is_roundtrip) {
+			bus.stops.push_back(bus.stops.front());
+		};
+		return bus;
+	}
+
+	void PrintRequest(std::ostream& out, const StopRequest& stop) {
+		out << "{\"type\": \"Stop\", \"name\": \"" << stop.name << "\", \"latitude\": " << stop.lat
+			<< ", \"longitude\": " << stop.lng << ", \"road_distances\": {";
+		bool is_first = true;
+		for (const auto& [other, length] : stop.distances) {
+			out << (is_first ? "" : ", ") << '"' << other << "\": " << length;
+			is_first = false;
+		};
+		out << "}}";
+	}
+
+	void PrintRequest(std::ostream& out, const BusRequest& bus) {
+		out << "{\"type\": \"Bus\", \"name\": \"" << bus.name << "\", \"is_roundtrip\": "
+			<< (bus.is_roundtrip ? "true" : "false") << ", \"stops\": [";
+		for (size_t i = 0; i < bus.stops.size(); ++i) {
+			out << (i == 0 ? "" : ", ") << '"' << bus.stops[i] << '"';
+		};
+		out << "]}";
+	}
+
+	std::string MakeInput(const std::vector<BaseRequest>& base_requests) {
+		std::ostringstream out;
+		out.precision(17);
+		out << "{\"base_requests\": [";
+		for (size_t i = 0; i < base_requests.size(); ++i) {
+			out << (i == 0 ? "" : ",\n");
+			std::visit([&out](const auto& request) { PrintRequest(out, request); }, base_requests[i]);
+		};
+		out << "],\n\"render_settings\": {\"width\": 1200.0, \"height\": 1200.0, \"padding\": 50.0, \"stop_radius\": 5,"
+			<< " \"line_width\": 14.0, \"bus_label_font_size\": 20, \"bus_label_offset\": [7.0, 15.0],"
+			<< " \"stop_label_font_size\": 20, \"stop_label_offset\": [7.0, -3.0], \"underlayer_color\": [255, 255, 255, 0.85],"
+			<< " \"underlayer_width\": 3.0, \"color_palette\": [\"green\", [255, 160, 0], \"red\"]},\n\"stat_requests\": [";
+		int id = 0;
+		for (int i = 0; i < BUSES_COUNT; ++i) {
+			out << "{\"id\": " << id++ << ", \"type\": \"Bus\", \"name\": \"Bus " << i << "\"},";
+		};
+		for (const int i : { 10, 20, 5000, 5001 }) {
+			out << "{\"id\": " << id++ << ", \"type\": \"Stop\", \"name\": \"" << StopName(i) << "\"},";
+		};
+		out << "{\"id\": " << id++ << ", \"type\": \"Map\"}]}";
+		return out.str();
+	}
+
+	std::string Process(const std::string& input, RequestHandler::LoadingMode mode) {
+		std::istringstream in(input);
+		std::ostringstream out;
+		transport::Catalogue catalogue;
+		render::MapRenderer renderer;
+		RequestHandler handler(in, out, catalogue, renderer);
+		handler.SetWorkersCount(4);
+		handler.SetLoadingMode(mode);
+		handler.ProcessAllRequests();
+		return out.str();
+	}
+
+	//key which follows object text in input is renamed, so object is given without it
+	std::string WithoutKey(std::string input, const std::string& object, const std::string& key) {
+		const size_t key_pos = input.find('"' + key + '"', input.find(object));
+		input[key_pos + key.size()] = '_';
+		return input;
+	}
+
+	//message of error or empty string if input is loaded
+	std::string LoadingError(const std::string& input, RequestHandler::LoadingMode mode) {
+		try {
+			Process(input, mode);
+		}
+		catch (const std::out_of_range& e) {
+			return e.what();
+		};
+		return {};
+	}
+}
+
+int main() {
+	std::vector<StopRequest> stops;
+	for (int i = 0; i < STOPS_COUNT; ++i) {
+		stops.push_back(MakeStop(i));
+	};
+	std::vector<BusRequest> buses;
+	for (int i = 0; i < BUSES_COUNT; ++i) {
+		buses.push_back(MakeBus(i));
+	};
+
+	//bus is given before its stops and is given again at the end, so its first route has only pending stops
+	std::vector<BaseRequest> with_duplicates;
+	with_duplicates.push_back(BusRequest{ "Bus 0", false, { StopName(5000), StopName(5001), StopName(5002) } });
+	for (int i = 0; i < STOPS_COUNT; ++i) {
+		//stop is given twice in a row, distances are merged and last length wins
+		if (i == 10) {
+			StopRequest first = stops[i];
+			first.lat += 0.01;
+			first.distances[StopName(11)] = 1;
+			with_duplicates.push_back(first);
+			stops[i].distances[StopName(12)] = 4321;
+		};
+		with_duplicates.push_back(stops[i]);
+	};
+	for (int i = 1; i < BUSES_COUNT; ++i) {
+		//bus is given twice in a row, only last route is kept
+		if (i == 1) {
+			with_duplicates.push_back(BusRequest{ buses[i].name, true, { StopName(7), StopName(8), StopName(7) } });
+		};
+		with_duplicates.push_back(buses[i]);
+	};
+	//stop is given again in other window with new coordinates and new length of existing distance
+	stops[20].lat += 0.02;
+	stops[20].distances[StopName(21)] = 777;
+	with_duplicates.push_back(StopRequest{ stops[20].name, stops[20].lat, stops[20].lng, { { StopName(21), 777 } } });
+	with_duplicates.push_back(buses[0]);
+
+	std::vector<BaseRequest> once;
+	once.insert(once.end(), stops.begin(), stops.end());
+	once.insert(once.end(), buses.begin(), buses.end());
+
+	const std::string expected = Process(MakeInput(once), RequestHandler::LoadingMode::DOCUMENT);
+	const std::string input = MakeInput(with_duplicates);
+	const std::pair<RequestHandler::LoadingMode, std::string> modes[] = {
+		{ RequestHandler::LoadingMode::DOCUMENT, "document"s },
+		{ RequestHandler::LoadingMode::STREAMING, "streaming"s },
+		{ RequestHandler::LoadingMode::PARALLEL, "parallel"s },
+	};
+	int failed = 0;
+	for (const auto& [mode, mode_name] : modes) {
+		if (Process(input, mode) != expected) {
+			std::cerr << "Duplicate names are loaded differently in " << mode_name << " mode" << std::endl;
+			++failed;
+		};
+	};
+
+	//every mode must reject object without required key by the same error
+	const std::pair<std::string, std::string> missing_keys[] = {
+		{ "\"type\": \"Stop\", \"name\": \"Stop 3000\"", "type" },
+		{ "\"type\": \"Stop\", \"name\": \"Stop 3000\"", "name" },
+		{ "\"name\": \"Stop 3000\"", "latitude" },
+		{ "\"name\": \"Stop 3000\"", "longitude" },
+		{ "\"name\": \"Stop 3000\"", "road_distances" },
+		{ "\"type\": \"Bus\", \"name\": \"Bus 7\",", "name" },
+		{ "\"name\": \"Bus 7\",", "is_roundtrip" },
+		{ "\"name\": \"Bus 7\",", "stops" },
+		{ "\"stat_requests\"", "id" },
+		{ "\"stat_requests\"", "type" },
+	};
+	const std::string once_input = MakeInput(once);
+	for (const auto& [object, key] : missing_keys) {
+		const std::string input = WithoutKey(once_input, object, key);
+		for (const auto& [mode, mode_name] : modes) {
+			if (const std::string error = LoadingError(input, mode); error != "Key is not found: "s + key) {
+				std::cerr << "Missing " << key << " after " << object << " gives error \"" << error << "\" in "
+					<< mode_name << " mode" << std::endl;
+				++failed;
+			};
+		};
+	};
+
+	if (failed == 0) {
+		std::cerr << "Loading modes test OK" << std::endl;
+	};
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
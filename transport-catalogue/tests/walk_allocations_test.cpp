@@ -0,0 +1,92 @@
+#include <iostream>
+#include <memory_resource>
+#include <string>
+
+#include "../json_reader.h"
+#include "../map_renderer.h"
+
+//document is walked by references, so no node of it is copied while data is loaded. copy of array or dict
+//takes memory from default resource, which is replaced by counter here while nothing else runs
+namespace {
+	const std::string INPUT = R"({
+		"base_requests": [
+			{ "type": "Bus", "name": "114", "stops": ["Sea Station", "Riviera Bridge"], "is_roundtrip": false },
+			{ "type": "Stop", "name": "Riviera Bridge", "latitude": 43.587795, "longitude": 39.716901, "road_distances": { "Sea Station": 850 } },
+			{ "type": "Stop", "name": "Sea \"Station\"", "latitude": 43.581969, "longitude": 39.719848, "road_distances": {} },
+			{ "type": "Stop", "name": "Sea Station", "latitude": 43.581969, "longitude": 39.719848, "road_distances": { "Riviera Bridge": 850 } }
+		],
+		"render_settings": {
+			"width": 200, "height": 200, "padding": 30, "stop_radius": 5, "line_width": 14,
+			"bus_label_font_size": 20, "bus_label_offset": [7, 15], "stop_label_font_size": 20, "stop_label_offset": [7, -3],
+			"underlayer_color": [255, 255, 255, 0.85], "underlayer_width": 3, "color_palette": ["green", [255, 160, 0], "red"]
+		},
+		"stat_requests": [
+			{ "id": 1, "type": "Map" },
+			{ "id": 2, "type": "Stop", "name": "Riviera Bridge" },
+			{ "id": 3, "type": "Bus", "name": "114" }
+		]
+	})";
+
+	//previous default resource is restored when counting ends
+	class DefaultResourceCounter {
+	public:
+		DefaultResourceCounter() : previous_(std::pmr::set_default_resource(&counter_)) {
+		}
+
+		~DefaultResourceCounter() {
+			std::pmr::set_default_resource(previous_);
+		}
+
+		size_t GetAllocationsCount() const {
+			return counter_.GetAllocationsCount();
+		}
+
+	private:
+		json::CountingResource counter_;
+		std::pmr::memory_resource* previous_;
+	};
+}
+
+int main() {
+	int failed = 0;
+
+	//counter must see copies of nodes, otherwise zero count of walk proves nothing
+	{
+		const json::Document document = json::Document::Borrow(INPUT);
+		DefaultResourceCounter counter;
+		const json::Node copy = document.GetRoot();
+		if (counter.GetAllocationsCount() == 0) {
+			std::cerr << "Copy of document root is not counted" << std::endl;
+			++failed;
+		};
+	}
+
+	json::JsonReader reader;
+	render::MapRenderer renderer;
+	size_t copies_allocations = 0;
+	{
+		DefaultResourceCounter counter;
+		reader.LoadData(INPUT, renderer);
+		copies_allocations = counter.GetAllocationsCount();
+	}
+	const json::JsonReader::LoadStats& stats = reader.GetLoadStats();
+	std::cerr << "document nodes: " << stats.document.nodes_allocations << " allocations in " << stats.document.heap_allocations
+		<< " arena chunks, walk: " << stats.walk_allocations << " allocations, copies: " << copies_allocations << " allocations" << std::endl;
+	if (copies_allocations != 0) {
+		std::cerr << "Nodes of document are copied while data is loaded" << std::endl;
+		++failed;
+	};
+	if (stats.walk_allocations == 0 || stats.document.nodes_allocations == 0) {
+		std::cerr << "Load stats are not collected" << std::endl;
+		++failed;
+	};
+	if (reader.GetParsedStops().size() != 3 || reader.GetParsedBuses().size() != 1 || reader.GetParsedRequests().size() != 3) {
+		std::cerr << "Data is loaded wrong" << std::endl;
+		++failed;
+	};
+
+	if (failed == 0) {
+		std::cerr << "Walk allocations test OK" << std::endl;
+	};
+	return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,131 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+
+namespace parallel {
+
+	ThreadPool::ThreadPool(size_t threads_count)
+		: threads_count_(std::max<size_t>(threads_count, 1)), queues_(new ChunksQueue[threads_count_]) {
+		//thread with index 0 is the one which calls ParallelFor
+		threads_.reserve(threads_count_ - 1);
+		for (size_t i = 1; i < threads_count_; ++i) {
+			threads_.emplace_back([this, i] { WorkerLoop(i); });
+		};
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard lock(mutex_);
+			stop_ = true;
+		}
+		start_.notify_all();
+		for (auto& thread : threads_) {
+			thread.join();
+		};
+	}
+
+	size_t ThreadPool::GetThreadsCount() const {
+		return threads_count_;
+	}
+
+	void ThreadPool::ParallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& func) {
+		if (count == 0) {
+			return;
+		};
+		chunk = std::max<size_t>(chunk, 1);
+		const size_t chunks_count = (count + chunk - 1) / chunk;
+		//nothing to share, working in calling thread
+		if (threads_count_ == 1 || chunks_count == 1) {
+			for (size_t begin = 0; begin < count; begin += chunk) {
+				func(begin, std::min(begin + chunk, count));
+			};
+			return;
+		};
+
+		//every thread gets equal part of chunks, parts are stolen if thread is late
+		for (size_t i = 0; i < threads_count_; ++i) {
+			std::lock_guard lock(queues_[i].mutex);
+			queues_[i].front = chunks_count * i / threads_count_;
+			queues_[i].back = chunks_count * (i + 1) / threads_count_;
+		};
+		{
+			std::lock_guard lock(mutex_);
+			func_ = &func;
+			count_ = count;
+			chunk_ = chunk;
+			error_ = nullptr;
+			running_ = threads_count_ - 1;
+			++generation_;
+		}
+		start_.notify_all();
+
+		Work(0);
+
+		std::unique_lock lock(mutex_);
+		finish_.wait(lock, [this] { return running_ == 0; });
+		func_ = nullptr;
+		if (error_) {
+			std::rethrow_exception(std::exchange(error_, nullptr));
+		};
+	}
+
+	void ThreadPool::WorkerLoop(size_t index) {
+		uint64_t done_generation = 0;
+		while (true) {
+			{
+				std::unique_lock lock(mutex_);
+				start_.wait(lock, [&] { return stop_ || generation_ != done_generation; });
+				if (stop_) {
+					return;
+				};
+				done_generation = generation_;
+			}
+			Work(index);
+			{
+				std::lock_guard lock(mutex_);
+				--running_;
+			}
+			finish_.notify_one();
+		};
+	}
+
+	void ThreadPool::Work(size_t index) {
+		size_t chunk_index{};
+		while (TakeOwnChunk(index, chunk_index) || StealChunk(index, chunk_index)) {
+			const size_t begin = chunk_index * chunk_;
+			try {
+				(*func_)(begin, std::min(begin + chunk_, count_));
+			}
+			catch (...) {
+				std::lock_guard lock(mutex_);
+				if (!error_) {
+					error_ = std::current_exception();
+				};
+			};
+		};
+	}
+
+	bool ThreadPool::TakeOwnChunk(size_t index, size_t& chunk_index) {
+		ChunksQueue& queue = queues_[index];
+		std::lock_guard lock(queue.mutex);
+		if (queue.front == queue.back) {
+			return false;
+		};
+		chunk_index = queue.front++;
+		return true;
+	}
+
+	bool ThreadPool::StealChunk(size_t index, size_t& chunk_index) {
+		//victims are checked starting from the next thread, so thieves dont crowd on one queue
+		for (size_t shift = 1; shift < threads_count_; ++shift) {
+			ChunksQueue& queue = queues_[(index + shift) % threads_count_];
+			std::lock_guard lock(queue.mutex);
+			if (queue.front != queue.back) {
+				chunk_index = --queue.back;
+				return true;
+			};
+		};
+		return false;
+	}
+
+}//end of namespace parallel
\ No newline at end of file
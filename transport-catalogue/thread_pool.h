@@ -0,0 +1,68 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace parallel {
+
+	//fixed set of threads which process ranges of items together with calling thread,
+	//every thread takes chunks from its own queue and steals from others when it is empty
+	class ThreadPool {
+	public:
+		//threads count includes calling thread, so pool of one thread starts nothing
+		explicit ThreadPool(size_t threads_count = std::thread::hardware_concurrency());
+
+		ThreadPool(const ThreadPool&) = delete;
+
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		~ThreadPool();
+
+		size_t GetThreadsCount() const;
+
+		//calls func(begin, end) for consecutive ranges of at most chunk items covering [0, count),
+		//returns when all ranges are processed, first exception of func is rethrown here.
+		//must not be called from func or from several threads at once
+		void ParallelFor(size_t count, size_t chunk, const std::function<void(size_t, size_t)>& func);
+
+	private:
+		//chunks indexes [front, back) not taken yet, owner takes from front, thieves from back
+		struct alignas(64) ChunksQueue {
+			std::mutex mutex;
+			size_t front{};
+			size_t back{};
+		};
+
+		const size_t threads_count_;
+		std::vector<std::thread> threads_{};
+		std::unique_ptr<ChunksQueue[]> queues_{};
+
+		std::mutex mutex_{};
+		std::condition_variable start_{};
+		std::condition_variable finish_{};
+		uint64_t generation_{}; //number of ParallelFor call, workers wait for it to change
+		size_t running_{}; //workers which didnt finish current call
+		bool stop_ = false;
+
+		//current task
+		const std::function<void(size_t, size_t)>* func_ = nullptr;
+		size_t count_{};
+		size_t chunk_{};
+		std::exception_ptr error_{};
+
+		void WorkerLoop(size_t index);
+
+		void Work(size_t index);
+
+		bool TakeOwnChunk(size_t index, size_t& chunk_index);
+
+		bool StealChunk(size_t index, size_t& chunk_index);
+	};
+
+}//end of namespace parallel
\ No newline at end of file
@@ -3,91 +3,311 @@
 using namespace objects;
 
 namespace transport {
+	namespace {
+		//ids are sorted by names of objects
+		template <typename Object>
+		const Object* FindByName(const std::vector<Object>& objects, const std::vector<uint32_t>& ids, std::string_view name) {
+			const auto found = std::lower_bound(ids.begin(), ids.end(), name, [&objects](uint32_t id, std::string_view value) {
+				return objects[id].name < value;
+			});
+			return found != ids.end() && objects[*found].name == name ? &objects[*found] : nullptr;
+		}
+
+		//checks that offsets split array of given size to parts of count items
+		void CheckOffsets(const std::vector<uint32_t>& offsets, size_t count, size_t size) {
+			if (offsets.size() != count + 1 || offsets[0] != 0 || offsets[count] != size) {
+				throw snapshot::SnapshotError("Snapshot has wrong offsets");
+			};
+			for (size_t i = 0; i < count; ++i) {
+				if (offsets[i] > offsets[i + 1]) {
+					throw snapshot::SnapshotError("Snapshot has wrong offsets");
+				};
+			};
+		}
+
+		//checks that every id is less than count
+		void CheckIds(const std::vector<uint32_t>& ids, size_t count) {
+			if (std::any_of(ids.begin(), ids.end(), [count](uint32_t id) { return id >= count; })) {
+				throw snapshot::SnapshotError("Snapshot has wrong ids");
+			};
+		}
+
+		//checks table of ids of objects sorted by names, names must be unique
+		template <typename Object>
+		void CheckNames(const std::vector<Object>& objects, const std::vector<uint32_t>& ids_by_name) {
+			CheckIds(ids_by_name, objects.size());
+			if (ids_by_name.size() != objects.size()) {
+				throw snapshot::SnapshotError("Snapshot has wrong names table");
+			};
+			for (size_t i = 1; i < ids_by_name.size(); ++i) {
+				if (!(objects[ids_by_name[i - 1]].name < objects[ids_by_name[i]].name)) {
+					throw snapshot::SnapshotError("Snapshot names table is not sorted");
+				};
+			};
+		}
+	} //end of anonymous namespace
+
 	void Catalogue::ParseRoutesLengths(const std::map<std::string, std::map<std::string, int>>& routes) {
+		CheckNotLoaded();
 		for (const auto& [first_stop, stops_with_length] : routes) {
 			const Stop* stop_a = FindStop(first_stop);
 			for (const auto& [second_stop, length] : stops_with_length) {
 				const Stop* stop_b = FindStop(second_stop);
-				const StopsPtrsPair stops_pair = { stop_a, stop_b };
-				routes_lengths_[stops_pair] = length;
+				routes_lengths_.Set(stop_a->id, stop_b->id, length);
 			};
 		};
+		++version_;
 	}
 
-	void Catalogue::AddStop(const std::string& name, const geo::Coordinates& point) {
-		stops_.emplace_back(name, point);
+	const Stop* Catalogue::AddStop(const std::string& name, const geo::Coordinates& point) {
+		CheckNotLoaded();
+		const std::string& stored_name = names_.emplace_back(name);
+		const Stop& stop = stops_.emplace_back(stored_name, geo::PreparedCoordinates(point), static_cast<uint32_t>(stops_.size()));
+		stops_index_[stop.name] = &stop;
+		++version_;
+		return &stop;
 	}
 
 	const Bus* Catalogue::AddBus(const std::string& name, const bool is_roundtrip) {
-		return &(buses_.emplace_back(name, is_roundtrip));
+		CheckNotLoaded();
+		const std::string& stored_name = names_.emplace_back(name);
+		const Bus& bus = buses_.emplace_back(stored_name, is_roundtrip, static_cast<uint32_t>(buses_.size()));
+		buses_index_[bus.name] = &bus;
+		//bus added after routes data is prepared has its flag too, its data is valid after next preparing
+		routes_data_flags_.emplace_back();
+		++version_;
+		return &bus;
 	}
 
+	void Catalogue::SetStopCoordinates(const Stop* stop_ptr, const geo::Coordinates& point) {
+		CheckNotLoaded();
+		const_cast<Stop*>(stop_ptr)->coordinates = geo::PreparedCoordinates(point);
+		++version_;
+	}
+
+	//old place of route in routes_stops_ stays unused, as when route is moved to the end
+	void Catalogue::ResetBusRoute(const Bus* bus_ptr, const bool is_roundtrip) {
+		CheckNotLoaded();
+		Bus& bus = *const_cast<Bus*>(bus_ptr);
+		bus.is_roundtrip = is_roundtrip;
+		bus.stops_count = 0;
+		++version_;
+	}
+
+	//buses for stops are collected later in BuildStopsBusesIndex
 	void Catalogue::ExpandBusAndStopInfo(const Bus* bus_ptr, const Stop* stop_ptr) {
-		const_cast<Bus*>(bus_ptr)->stops.push_back(stop_ptr);
-		const_cast<Stop*>(stop_ptr)->buses.insert(bus_ptr);
+		CheckNotLoaded();
+		AppendRouteStop(bus_ptr, stop_ptr->id);
+		++version_;
 	}
 
 	void Catalogue::ExpandBusAndStopInfo(const Stop* stop_ptr, const Bus* bus_ptr) {
-		const_cast<Stop*>(stop_ptr)->buses.insert(bus_ptr);
-		const_cast<Bus*>(bus_ptr)->stops.push_back(stop_ptr);
+		ExpandBusAndStopInfo(bus_ptr, stop_ptr);
 	}
 
-	const Stop* Catalogue::FindStop(const std::string& stop) {
-		auto search_res = find(stops_.begin(), stops_.end(), stop);
-		return search_res == stops_.end() ? nullptr : &(*search_res);
+	size_t Catalogue::AddBusStopPlaceholder(const Bus* bus_ptr) {
+		CheckNotLoaded();
+		const size_t index = AppendRouteStop(bus_ptr, 0);
+		++version_;
+		return index;
 	}
 
-	const Bus* Catalogue::FindBus(const std::string& bus) {
-		auto search_res = find(buses_.begin(), buses_.end(), bus);
-		return search_res == buses_.end() ? nullptr : &(*search_res);
+	void Catalogue::SetBusStop(const Bus* bus_ptr, size_t index, const Stop* stop_ptr) {
+		CheckNotLoaded();
+		if (index >= bus_ptr->stops_count) {
+			throw std::out_of_range("Stop index is out of route");
+		};
+		routes_stops_[bus_ptr->stops_begin + index] = stop_ptr->id;
+		++version_;
 	}
 
-	const std::set<const Bus*, BusPtrComp>& Catalogue::GetBusesForStop(const Stop* stop_ptr) {
-		return stop_ptr->buses;
+	size_t Catalogue::AppendRouteStop(const Bus* bus_ptr, uint32_t stop_id) {
+		Bus& bus = *const_cast<Bus*>(bus_ptr);
+		if (bus.stops_begin + bus.stops_count != routes_stops_.size()) {
+			//other route got stops after this one, so its stops are copied to the end, old place stays unused
+			const size_t begin = routes_stops_.size();
+			routes_stops_.resize(begin + bus.stops_count);
+			std::copy_n(routes_stops_.begin() + bus.stops_begin, bus.stops_count, routes_stops_.begin() + begin);
+			bus.stops_begin = static_cast<uint32_t>(begin);
+		};
+		routes_stops_.push_back(stop_id);
+		return bus.stops_count++;
+	}
+
+	RouteView Catalogue::GetRoute(const Bus* bus_ptr) const {
+		return RouteView(RouteStops(*bus_ptr), bus_ptr->is_roundtrip);
+	}
+
+	IdsRange Catalogue::RouteStops(const Bus& bus) const {
+		const uint32_t* stops = routes_stops_.data() + bus.stops_begin;
+		return { stops, stops + bus.stops_count };
+	}
+
+	IdsRange Catalogue::RouteEdges(const Bus& bus) const {
+		const uint32_t* edges = routes_edges_.data() + bus.edges_begin;
+		return { edges, edges + bus.edges_count };
+	}
+
+	const Stop* Catalogue::FindStop(std::string_view stop) const {
+		if (loaded_) {
+			return FindByName(loaded_->stops, loaded_->stops_by_name, stop);
+		};
+		auto search_res = stops_index_.find(stop);
+		return search_res == stops_index_.end() ? nullptr : search_res->second;
+	}
+
+	const Bus* Catalogue::FindBus(std::string_view bus) const {
+		if (loaded_) {
+			return FindByName(loaded_->buses, loaded_->buses_by_name, bus);
+		};
+		auto search_res = buses_index_.find(bus);
+		return search_res == buses_index_.end() ? nullptr : search_res->second;
+	}
+
+	IdsRange Catalogue::GetBusesForStop(const Stop* stop_ptr) const {
+		if (stop_ptr->id + 1 >= stop_buses_offsets_.size()) { //index is not built yet
+			return { nullptr, nullptr };
+		};
+		return { stop_buses_.data() + stop_buses_offsets_[stop_ptr->id], stop_buses_.data() + stop_buses_offsets_[stop_ptr->id + 1] };
+	}
+
+	ObjectsView<Stop> Catalogue::GetStops() const {
+		return loaded_ ? ObjectsView<Stop>(loaded_->stops.data(), loaded_->stops.size()) : ObjectsView<Stop>(stops_);
+	}
+
+	ObjectsView<Bus> Catalogue::GetBuses() const {
+		return loaded_ ? ObjectsView<Bus>(loaded_->buses.data(), loaded_->buses.size()) : ObjectsView<Bus>(buses_);
+	}
+
+	ObjectsView<Edge> Catalogue::GetEdges() const {
+		return ObjectsView<Edge>(edges_.data(), edges_.size());
+	}
+
+	std::pair<uint32_t, uint32_t> Catalogue::GetStopEdges(const Stop* stop_ptr) const {
+		if (stop_ptr->id + 1 >= stop_edges_offsets_.size()) { //edges are not built yet
+			return { 0, 0 };
+		};
+		return { stop_edges_offsets_[stop_ptr->id], stop_edges_offsets_[stop_ptr->id + 1] };
 	}
 
 	void Catalogue::SetStopsDistance(const Stop* a,
 		const Stop* b, const size_t length) {
-		routes_lengths_[StopsPtrsPair(a, b)] = length;
+		CheckNotLoaded();
+		routes_lengths_.Set(a->id, b->id, length);
+		++version_;
 	}
 
-	size_t Catalogue::GetStopsDistance(const Stop* a, const Stop* b) {
-		return routes_lengths_.at(StopsPtrsPair(a, b));
+	size_t Catalogue::GetStopsDistance(const Stop* a, const Stop* b) const {
+		return routes_lengths_.At(a->id, b->id);
 	}
 
-	void Catalogue::CalculateRoutesData() {
-		for (auto& bus : buses_) {
-			RouteData data{};
-			//getting count of unique stops in separate namespace to save memory
-			{
-				data.unique_stops = std::set(bus.stops.begin(), bus.stops.end()).size();
-			}
+	Catalogue::~Catalogue() {
+		if (routes_data_warm_up_.joinable()) {
+			routes_data_warm_up_.join();
+		};
+	}
+
+	void Catalogue::CalculateRoutesData(parallel::ThreadPool* workers) {
+		if (loaded_) { //routes data is loaded with catalogue
+			return;
+		};
+		ResetRoutesData();
+
+		const auto calculate = [this](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				GetRouteData(&buses_[i]);
+			};
+		};
+		if (workers == nullptr) {
+			calculate(0, buses_.size());
+		}
+		else {
+			workers->ParallelFor(buses_.size(), BUSES_CHUNK, calculate);
+		};
+	}
+
+	void Catalogue::PrepareRoutesDataOnDemand(const bool warm_up) {
+		if (loaded_) {
+			return;
+		};
+		ResetRoutesData();
 
-			//getting stop count for bus
-			data.stops_count = bus.stops.size();
-
-			//getting sum of the lengths between stops pointers and curvature
-			const auto& stops = bus.stops;
-			double curvatures{};
-			for (size_t i = 0; i < stops.size() - 1; ++i) {
-				//if length between stops as in bus route doesnt exist, getting length of reversed stops
-				if (routes_lengths_.count({ stops.at(i), stops.at(i + 1) })) {
-					data.length += routes_lengths_.at({ stops.at(i), stops.at(i + 1) });
-				}
-				else if (routes_lengths_.count({ stops.at(i + 1), stops.at(i) })) {
-					data.length += routes_lengths_.at({ stops.at(i + 1), stops.at(i) });
+		if (warm_up) {
+			//requests are answered meanwhile, data which is needed first is calculated by them
+			routes_data_warm_up_ = std::thread([this] {
+				for (const auto& bus : buses_) {
+					GetRouteData(&bus);
 				};
-				//summing computed curvatures
-				curvatures += geo::ComputeDistance(stops.at(i)->coordinates, stops.at(i + 1)->coordinates);
+			});
+		};
+	}
+
+	const RouteData& Catalogue::GetRouteData(const Bus* bus_ptr) const {
+		if (bus_ptr->id >= (loaded_ ? loaded_->buses.size() : routes_data_flags_.size())) {
+			throw std::out_of_range("Bus is not in catalogue: "s + std::string(bus_ptr->name));
+		};
+		if (loaded_) {
+			return bus_ptr->route_data;
+		};
+		std::call_once(routes_data_flags_[bus_ptr->id], [this, bus_ptr] {
+			const_cast<Bus*>(bus_ptr)->route_data = CalculateRouteData(*bus_ptr);
+		});
+		return bus_ptr->route_data;
+	}
+
+	size_t Catalogue::CountUniqueStops(const Bus& bus) const {
+		//stop is counted if it is not marked by current epoch yet, so marks are not cleared between buses.
+		//every thread has own marks, they are allocated once and are reused by all buses
+		thread_local std::vector<uint32_t> marks;
+		thread_local uint32_t epoch = 0;
+		if (marks.size() < stops_.size()) {
+			marks.resize(stops_.size(), 0);
+		};
+		if (++epoch == 0) { //all epochs are used, old marks could be taken for new ones
+			std::fill(marks.begin(), marks.end(), 0);
+			epoch = 1;
+		};
+
+		size_t unique_stops = 0;
+		for (const uint32_t stop_id : RouteStops(bus)) {
+			if (marks[stop_id] != epoch) {
+				marks[stop_id] = epoch;
+				++unique_stops;
 			};
-			//curvature of all route. in case if length is zero, curvature will be zero too
-			data.curvature = (data.length == 0) ? 0 : data.length / curvatures;
-			//writing all data to catalogue
-			bus.route_data = data;
 		};
+		return unique_stops;
+	}
+
+	void Catalogue::ResetRoutesData() {
+		if (routes_data_warm_up_.joinable()) {
+			routes_data_warm_up_.join();
+		};
+		BuildStopsBusesIndex();
+		BuildEdges();
+		//flags cant be moved, so new deque is constructed in place of old one
+		routes_data_flags_ = std::deque<std::once_flag>(buses_.size());
+	}
+
+	RouteData Catalogue::CalculateRouteData(const Bus& bus) const {
+		RouteData data{};
+		data.unique_stops = CountUniqueStops(bus);
+
+		//getting stop count for bus
+		data.stops_count = GetRoute(&bus).size();
+
+		//getting sum of the lengths of route segments and curvature, all lengths are resolved in edges
+		double curvatures{};
+		for (const uint32_t edge_id : RouteEdges(bus)) {
+			const Edge& edge = edges_[edge_id];
+			data.length += edge.road_length;
+			curvatures += edge.geo_length;
+		};
+		//curvature of all route. in case if length is zero, curvature will be zero too
+		data.curvature = (data.length == 0) ? 0 : data.length / curvatures;
+		return data;
 	}
 
-	const RequestAnswer Catalogue::ConstructAnswerForRequest(const Request& request) {
+	const RequestAnswer Catalogue::ConstructAnswerForRequest(const Request& request) const {
 
 		RequestAnswer answer;
 		answer.id = request.id;
@@ -101,12 +321,11 @@ namespace transport {
 			}
 			else {
 				std::vector<std::string> buses;
+				const ObjectsView<Bus> all_buses = GetBuses();
 				//in case if stop doesnt have buses, adding empty array
-				if (!(stop_ptr->buses.empty())) {
-					//converting pointers to strings, filling vector of buses
-					for (const auto& bus_ptr : stop_ptr->buses) {
-						buses.push_back(bus_ptr->name);
-					};
+				//converting ids to strings, filling vector of buses
+				for (const uint32_t bus_id : GetBusesForStop(stop_ptr)) {
+					buses.emplace_back(all_buses[bus_id].name);
 				};
 				answer.data = buses;
 			};
@@ -120,18 +339,322 @@ namespace transport {
 			}
 			else {
 				//if bus exists getting route data
-				answer.data = bus_ptr->route_data;
+				answer.data = GetRouteData(bus_ptr);
 			};
 		};
 
 		return answer;
 	}
 
-	const std::vector<const Bus*> Catalogue::RoutesForMap() {
-		std::set<const Bus*, BusPtrComp> routes;
+	const std::vector<BusRoute> Catalogue::RoutesForMap() const {
+		std::vector<BusRoute> routes;
+		for (const Bus* bus_ptr : SortedBuses()) {
+			routes.push_back({ bus_ptr, GetRoute(bus_ptr) });
+		};
+		return routes;
+	}
+
+	uint64_t Catalogue::GetVersion() const {
+		return version_;
+	}
+
+	void Catalogue::Save(snapshot::Writer& writer) const {
+		using snapshot::Section;
+
+		for (const Stop& stop : GetStops()) {
+			snapshot::StopRecord record;
+			record.name = writer.AddString(stop.name);
+			record.lat = stop.coordinates.lat;
+			record.lng = stop.coordinates.lng;
+			record.sin_lat = stop.coordinates.sin_lat;
+			record.cos_lat = stop.coordinates.cos_lat;
+			writer.Add(Section::STOPS, record);
+		};
+
+		//routes are written one after another, so places left by moved routes are not saved
+		for (const Bus& bus : GetBuses()) {
+			const RouteData& data = GetRouteData(&bus);
+			snapshot::BusRecord record;
+			record.name = writer.AddString(bus.name);
+			record.stops_begin = static_cast<uint32_t>(writer.Count<uint32_t>(Section::ROUTES_STOPS));
+			record.stops_count = bus.stops_count;
+			record.edges_begin = static_cast<uint32_t>(writer.Count<uint32_t>(Section::ROUTES_EDGES));
+			record.edges_count = bus.edges_count;
+			record.unique_stops = data.unique_stops;
+			record.route_stops_count = data.stops_count;
+			record.length = data.length;
+			record.curvature = data.curvature;
+			record.is_roundtrip = bus.is_roundtrip ? 1 : 0;
+			writer.Add(Section::BUSES, record);
+			writer.Add(Section::ROUTES_STOPS, RouteStops(bus).begin(), bus.stops_count);
+			writer.Add(Section::ROUTES_EDGES, RouteEdges(bus).begin(), bus.edges_count);
+		};
+
+		for (const Stop* stop_ptr : SortedStops()) {
+			writer.Add(Section::STOPS_BY_NAME, stop_ptr->id);
+		};
+		for (const Bus* bus_ptr : SortedBuses()) {
+			writer.Add(Section::BUSES_BY_NAME, bus_ptr->id);
+		};
+
+		for (const Edge& edge : edges_) {
+			writer.Add(Section::EDGES, snapshot::EdgeRecord{ edge.from, edge.to, edge.road_length, edge.geo_length });
+		};
+		writer.Add(Section::STOPS_EDGES_OFFSETS, stop_edges_offsets_.data(), stop_edges_offsets_.size());
+		writer.Add(Section::STOPS_BUSES_OFFSETS, stop_buses_offsets_.data(), stop_buses_offsets_.size());
+		writer.Add(Section::STOPS_BUSES, stop_buses_.data(), stop_buses_.size());
+		for (const StopsDistanceTable::Slot& slot : routes_lengths_.GetSlots()) {
+			writer.Add(Section::DISTANCES, snapshot::DistanceRecord{ slot.key, slot.length });
+		};
+	}
+
+	void Catalogue::Load(const snapshot::View& view) {
+		using snapshot::Section;
+
+		//everything is read and checked before catalogue is changed, so catalogue stays as it was if snapshot is wrong
+		const size_t stops_count = view.Count<snapshot::StopRecord>(Section::STOPS);
+		const size_t buses_count = view.Count<snapshot::BusRecord>(Section::BUSES);
+		if (stops_count > std::numeric_limits<uint32_t>::max() || buses_count > std::numeric_limits<uint32_t>::max()) {
+			throw snapshot::SnapshotError("Snapshot has too many objects");
+		};
+		std::vector<uint32_t> routes_stops = view.ReadAll<uint32_t>(Section::ROUTES_STOPS);
+		std::vector<uint32_t> routes_edges = view.ReadAll<uint32_t>(Section::ROUTES_EDGES);
+
+		LoadedObjects loaded;
+		loaded.stops.reserve(stops_count);
+		for (size_t i = 0; i < stops_count; ++i) {
+			const snapshot::StopRecord record = view.Read<snapshot::StopRecord>(Section::STOPS, i);
+			geo::PreparedCoordinates coordinates;
+			coordinates.lat = record.lat;
+			coordinates.lng = record.lng;
+			coordinates.sin_lat = record.sin_lat;
+			coordinates.cos_lat = record.cos_lat;
+			loaded.stops.emplace_back(view.GetString(record.name), coordinates, static_cast<uint32_t>(i));
+		};
+		loaded.buses.reserve(buses_count);
+		for (size_t i = 0; i < buses_count; ++i) {
+			const snapshot::BusRecord record = view.Read<snapshot::BusRecord>(Section::BUSES, i);
+			if (record.is_roundtrip > 1) {
+				throw snapshot::SnapshotError("Snapshot has wrong bus");
+			};
+			if (record.stops_begin > routes_stops.size() || record.stops_count > routes_stops.size() - record.stops_begin
+				|| record.edges_begin > routes_edges.size() || record.edges_count > routes_edges.size() - record.edges_begin) {
+				throw snapshot::SnapshotError("Snapshot route is out of routes section");
+			};
+			Bus& bus = loaded.buses.emplace_back(view.GetString(record.name), record.is_roundtrip == 1, static_cast<uint32_t>(i));
+			bus.stops_begin = record.stops_begin;
+			bus.stops_count = record.stops_count;
+			bus.edges_begin = record.edges_begin;
+			bus.edges_count = record.edges_count;
+			bus.route_data = { static_cast<size_t>(record.unique_stops), static_cast<size_t>(record.route_stops_count),
+				static_cast<size_t>(record.length), record.curvature };
+		};
+		loaded.stops_by_name = view.ReadAll<uint32_t>(Section::STOPS_BY_NAME);
+		loaded.buses_by_name = view.ReadAll<uint32_t>(Section::BUSES_BY_NAME);
+		CheckNames(loaded.stops, loaded.stops_by_name);
+		CheckNames(loaded.buses, loaded.buses_by_name);
+
+		std::vector<Edge> edges;
+		edges.reserve(view.Count<snapshot::EdgeRecord>(Section::EDGES));
+		for (size_t i = 0; i < edges.capacity(); ++i) {
+			const snapshot::EdgeRecord record = view.Read<snapshot::EdgeRecord>(Section::EDGES, i);
+			if (record.from >= stops_count || record.to >= stops_count) {
+				throw snapshot::SnapshotError("Snapshot has wrong ids");
+			};
+			edges.push_back({ record.from, record.to, static_cast<size_t>(record.road_length), record.geo_length });
+		};
+		std::vector<uint32_t> stop_edges_offsets = view.ReadAll<uint32_t>(Section::STOPS_EDGES_OFFSETS);
+		std::vector<uint32_t> stop_buses_offsets = view.ReadAll<uint32_t>(Section::STOPS_BUSES_OFFSETS);
+		std::vector<uint32_t> stop_buses = view.ReadAll<uint32_t>(Section::STOPS_BUSES);
+		CheckIds(routes_stops, stops_count);
+		CheckIds(routes_edges, edges.size());
+		CheckIds(stop_buses, buses_count);
+		CheckOffsets(stop_edges_offsets, stops_count, edges.size());
+		CheckOffsets(stop_buses_offsets, stops_count, stop_buses.size());
+
+		std::vector<StopsDistanceTable::Slot> slots(view.Count<snapshot::DistanceRecord>(Section::DISTANCES));
+		for (size_t i = 0; i < slots.size(); ++i) {
+			const snapshot::DistanceRecord record = view.Read<snapshot::DistanceRecord>(Section::DISTANCES, i);
+			slots[i] = { record.key, static_cast<size_t>(record.length) };
+		};
+		StopsDistanceTable routes_lengths;
+		try {
+			routes_lengths = StopsDistanceTable::FromSlots(std::move(slots), stops_count);
+		}
+		catch (const std::invalid_argument& e) {
+			throw snapshot::SnapshotError(e.what());
+		};
+
+		if (routes_data_warm_up_.joinable()) {
+			routes_data_warm_up_.join();
+		};
+		//built data is dropped, loaded catalogue keeps its names in snapshot
+		loaded_ = std::move(loaded);
+		routes_lengths_ = std::move(routes_lengths);
+		stops_index_.clear();
+		buses_index_.clear();
+		stops_.clear();
+		buses_.clear();
+		names_.clear();
+		routes_stops_ = std::move(routes_stops);
+		routes_edges_ = std::move(routes_edges);
+		stop_buses_offsets_ = std::move(stop_buses_offsets);
+		stop_buses_ = std::move(stop_buses);
+		edges_ = std::move(edges);
+		stop_edges_offsets_ = std::move(stop_edges_offsets);
+		routes_data_flags_.clear();
+		++version_;
+	}
+
+	void Catalogue::CheckNotLoaded() const {
+		if (loaded_) {
+			throw std::logic_error("Catalogue loaded from snapshot cant be changed");
+		};
+	}
+
+	std::vector<const Bus*> Catalogue::SortedBuses() const {
+		std::vector<const Bus*> buses;
+		if (loaded_) { //snapshot keeps buses sorted by names
+			for (const uint32_t bus_id : loaded_->buses_by_name) {
+				buses.push_back(&loaded_->buses[bus_id]);
+			};
+			return buses;
+		};
+		buses.reserve(buses_.size());
 		for (const auto& bus : buses_) {
-			routes.insert(&bus);
+			buses.push_back(&bus);
+		};
+		std::sort(buses.begin(), buses.end(), BusPtrComp{});
+		return buses;
+	}
+
+	std::vector<const Stop*> Catalogue::SortedStops() const {
+		std::vector<const Stop*> stops;
+		if (loaded_) {
+			for (const uint32_t stop_id : loaded_->stops_by_name) {
+				stops.push_back(&loaded_->stops[stop_id]);
+			};
+			return stops;
+		};
+		stops.reserve(stops_.size());
+		for (const auto& stop : stops_) {
+			stops.push_back(&stop);
+		};
+		std::sort(stops.begin(), stops.end(), StopPtrComp{});
+		return stops;
+	}
+
+	void Catalogue::BuildEdges() {
+		//segments of all routes are grouped by first stop in flat array as in BuildStopsBusesIndex,
+		//for every segment its stop and place of its edge id in route are kept
+		//edges ids of routes are placed in buses order
+		std::vector<uint32_t> offsets(stops_.size() + 1, 0);
+		size_t routes_edges_count = 0;
+		for (auto& bus : buses_) {
+			const RouteView route = GetRoute(&bus);
+			bus.edges_begin = static_cast<uint32_t>(routes_edges_count);
+			bus.edges_count = static_cast<uint32_t>(route.empty() ? 0 : route.size() - 1);
+			routes_edges_count += bus.edges_count;
+			for (size_t i = 0; i + 1 < route.size(); ++i) {
+				++offsets[route[i] + 1];
+			};
+		};
+		routes_edges_.assign(routes_edges_count, 0);
+		for (size_t i = 1; i < offsets.size(); ++i) {
+			offsets[i] += offsets[i - 1];
+		};
+		std::vector<uint32_t> segments_to(offsets.back());
+		std::vector<uint32_t> segments_edges(offsets.back()); //places of edges ids in routes_edges_
+		std::vector<uint32_t> position(offsets.begin(), offsets.end() - 1);
+		for (const auto& bus : buses_) {
+			const RouteView route = GetRoute(&bus);
+			for (size_t i = 0; i + 1 < route.size(); ++i) {
+				const uint32_t place = position[route[i]]++;
+				segments_to[place] = route[i + 1];
+				segments_edges[place] = static_cast<uint32_t>(bus.edges_begin + i);
+			};
+		};
+
+		//same segments of one stop are found by marks of second stops, mark is valid if it was made for current stop,
+		//so edges of every stop are placed together and no hashing is needed
+		edges_.clear();
+		stop_edges_offsets_.assign(stops_.size() + 1, 0);
+		std::vector<uint32_t> mark_stop(stops_.size(), static_cast<uint32_t>(stops_.size()));
+		std::vector<uint32_t> mark_edge(stops_.size());
+		for (uint32_t from = 0; from < stops_.size(); ++from) {
+			for (uint32_t place = offsets[from]; place < offsets[from + 1]; ++place) {
+				const uint32_t to = segments_to[place];
+				if (mark_stop[to] != from) {
+					mark_stop[to] = from;
+					mark_edge[to] = static_cast<uint32_t>(edges_.size());
+
+					Edge edge{};
+					edge.from = from;
+					edge.to = to;
+					//if length between stops as in bus route doesnt exist, getting length of reversed stops
+					if (const size_t* length = routes_lengths_.Find(from, to)) {
+						edge.road_length = *length;
+					}
+					else if (const size_t* reversed_length = routes_lengths_.Find(to, from)) {
+						edge.road_length = *reversed_length;
+					};
+					edges_.push_back(edge);
+				};
+				routes_edges_[segments_edges[place]] = mark_edge[to];
+			};
+			stop_edges_offsets_[from + 1] = static_cast<uint32_t>(edges_.size());
+		};
+
+		//geographical lengths are computed at once for blocks of edges, so points buffers stay small
+		geo::PointsBuffer from_points, to_points;
+		double geo_lengths[EDGES_BLOCK];
+		for (size_t first = 0; first < edges_.size(); first += EDGES_BLOCK) {
+			const size_t count = std::min(EDGES_BLOCK, edges_.size() - first);
+			from_points.Clear();
+			to_points.Clear();
+			for (size_t i = first; i < first + count; ++i) {
+				from_points.Add(stops_[edges_[i].from].coordinates);
+				to_points.Add(stops_[edges_[i].to].coordinates);
+			};
+			geo::ComputeDistances(from_points.Arrays(), to_points.Arrays(), count, geo_lengths);
+			for (size_t i = 0; i < count; ++i) {
+				edges_[first + i].geo_length = geo_lengths[i];
+			};
+		};
+	}
+
+	void Catalogue::BuildStopsBusesIndex() {
+		//buses are visited in order of their names, so buses of every stop come out sorted
+		const std::vector<const Bus*> buses = SortedBuses();
+		//last bus which was counted for stop, bus can pass same stop several times
+		const uint32_t no_bus = static_cast<uint32_t>(buses_.size());
+		std::vector<uint32_t> last_bus(stops_.size(), no_bus);
+
+		//counting buses for every stop and converting counts to offsets
+		stop_buses_offsets_.assign(stops_.size() + 1, 0);
+		for (const Bus* bus_ptr : buses) {
+			for (const uint32_t stop_id : RouteStops(*bus_ptr)) {
+				if (last_bus[stop_id] != bus_ptr->id) {
+					last_bus[stop_id] = bus_ptr->id;
+					++stop_buses_offsets_[stop_id + 1];
+				};
+			};
+		};
+		for (size_t i = 1; i < stop_buses_offsets_.size(); ++i) {
+			stop_buses_offsets_[i] += stop_buses_offsets_[i - 1];
+		};
+
+		//filling flat array, position is a next free place in stop part of array
+		stop_buses_.assign(stop_buses_offsets_.back(), 0);
+		std::vector<uint32_t> position(stop_buses_offsets_.begin(), stop_buses_offsets_.end() - 1);
+		last_bus.assign(stops_.size(), no_bus);
+		for (const Bus* bus_ptr : buses) {
+			for (const uint32_t stop_id : RouteStops(*bus_ptr)) {
+				if (last_bus[stop_id] != bus_ptr->id) {
+					last_bus[stop_id] = bus_ptr->id;
+					stop_buses_[position[stop_id]++] = bus_ptr->id;
+				};
+			};
 		};
-		return std::vector<const Bus*>(routes.begin(), routes.end());
 	}
 }
\ No newline at end of file
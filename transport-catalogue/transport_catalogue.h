@@ -10,9 +10,15 @@
 #include <set>
 #include <deque>
 #include <variant>
+#include <mutex>
+#include <thread>
+#include <optional>
+#include <limits>
 
 #include "geo.h"
 #include "domain.h"
+#include "thread_pool.h"
+#include "snapshot.h"
 
 using namespace std::string_literals;
 using namespace objects;
@@ -22,35 +28,149 @@ namespace transport {
 	public:
 		Catalogue() = default;
 
+		Catalogue(const Catalogue&) = delete;
+
+		Catalogue& operator=(const Catalogue&) = delete;
+
+		//waits for background calculation of routes data
+		~Catalogue();
+
 		void ParseRoutesLengths(const std::map<std::string, std::map<std::string, int>>&);
 
-		void AddStop(const std::string&, const geo::Coordinates&);
+		const Stop* AddStop(const std::string&, const geo::Coordinates&);
 
 		const Bus* AddBus(const std::string&, const bool);
 
+		//stop which is given again keeps its id, distances and buses, only coordinates are replaced
+		void SetStopCoordinates(const Stop*, const geo::Coordinates&);
+
+		//bus which is given again keeps its id, old stops of route are dropped
+		void ResetBusRoute(const Bus*, const bool is_roundtrip);
+
 		void ExpandBusAndStopInfo(const Bus*, const Stop*);
 
+		//adds route stop which is not in catalogue yet, returns its index in route to set it by SetBusStop later
+		size_t AddBusStopPlaceholder(const Bus*);
+
+		void SetBusStop(const Bus*, size_t index, const Stop*);
+
+		//all stops of route in order of movement
+		RouteView GetRoute(const Bus*) const;
+
 		void ExpandBusAndStopInfo(const Stop*, const Bus*);
 
-		const Stop* FindStop(const std::string&);
+		const Stop* FindStop(std::string_view) const;
 
-		const Bus* FindBus(const std::string&);
+		const Bus* FindBus(std::string_view) const;
 
-		const std::set<const Bus*, BusPtrComp>& GetBusesForStop(const Stop*);
+		//buses ids sorted by names, valid after CalculateRoutesData or PrepareRoutesDataOnDemand
+		IdsRange GetBusesForStop(const Stop*) const;
+
+		ObjectsView<Stop> GetStops() const;
+
+		//all segments of routes sorted by first stop, valid after CalculateRoutesData or PrepareRoutesDataOnDemand
+		ObjectsView<Edge> GetEdges() const;
+
+		//ids of edges which start from stop
+		std::pair<uint32_t, uint32_t> GetStopEdges(const Stop*) const;
 
 		void SetStopsDistance(const Stop*, const Stop*, const size_t);
 
-		size_t GetStopsDistance(const Stop*, const Stop*);
+		size_t GetStopsDistance(const Stop*, const Stop*) const;
+
+		//buses are shared between workers if they are passed, every bus data is written only by one thread
+		void CalculateRoutesData(parallel::ThreadPool* workers = nullptr);
+
+		//prepares catalogue for requests without calculating routes data, data of every bus
+		//is calculated on first GetRouteData call. if warm_up is set, all data is calculated by background thread
+		void PrepareRoutesDataOnDemand(const bool warm_up = false);
+
+		//calculated only once for every bus, can be called from several threads at once
+		const RouteData& GetRouteData(const Bus*) const;
+
+		//doesnt change catalogue, so answers can be constructed from several threads at once
+		const RequestAnswer ConstructAnswerForRequest(const Request&) const;
+
+		//buses sorted by names with their routes
+		const std::vector<BusRoute> RoutesForMap() const;
 
-		void CalculateRoutesData();
+		//version is changed by every modification of stops, buses or distances
+		uint64_t GetVersion() const;
 
-		const RequestAnswer ConstructAnswerForRequest(const Request&);
+		//saves stops, buses, distances and all calculated data, valid after CalculateRoutesData
+		//or PrepareRoutesDataOnDemand, data of buses which is not calculated yet is calculated here
+		void Save(snapshot::Writer&) const;
 
-		const std::vector<const Bus*> RoutesForMap();
+		//replaces all data by data of snapshot, nothing is calculated. names are not copied, so snapshot
+		//must outlive catalogue. all records are checked before catalogue is changed.
+		//loaded catalogue cant be changed, all modifiers throw logic_error
+		void Load(const snapshot::View&);
 
 	private:
-		std::unordered_map<const StopsPtrsPair, size_t, StopsPtrsPairHasher> routes_lengths_{};
+		StopsDistanceTable routes_lengths_{};
+		uint64_t version_{};
+		std::deque<std::string> names_{}; //chars of names of stops and buses
 		std::deque<Stop> stops_{};
 		std::deque<Bus> buses_{};
+		//indexes by name, keys are views to names stored in deques above
+		std::unordered_map<std::string_view, const Stop*> stops_index_{};
+		std::unordered_map<std::string_view, const Bus*> buses_index_{};
+		//routes of all buses, every bus keeps its ranges in these arrays. stops of every route
+		//are placed together, route is moved to the end if other route got stops after it
+		std::vector<uint32_t> routes_stops_{};
+		std::vector<uint32_t> routes_edges_{};
+		//buses for every stop in CSR form: buses of stop with id i are
+		//stop_buses_[stop_buses_offsets_[i]] ... stop_buses_[stop_buses_offsets_[i + 1] - 1]
+		std::vector<uint32_t> stop_buses_offsets_{};
+		std::vector<uint32_t> stop_buses_{};
+		//edges are sorted by first stop, edges from stop with id i are
+		//edges_[stop_edges_offsets_[i]] ... edges_[stop_edges_offsets_[i + 1] - 1]
+		std::vector<Edge> edges_{};
+		std::vector<uint32_t> stop_edges_offsets_{};
+		//flags of calculated routes data, indexed by buses ids
+		mutable std::deque<std::once_flag> routes_data_flags_{};
+		std::thread routes_data_warm_up_{};
+
+		//stops and buses of loaded snapshot, they are found by binary search in ids sorted by names,
+		//names are views to chars of snapshot. other loaded arrays are kept in containers above
+		struct LoadedObjects {
+			std::vector<Stop> stops;
+			std::vector<Bus> buses;
+			std::vector<uint32_t> stops_by_name;
+			std::vector<uint32_t> buses_by_name;
+		};
+		std::optional<LoadedObjects> loaded_{};
+
+		ObjectsView<Bus> GetBuses() const;
+
+		//modifiers are called only for built catalogue
+		void CheckNotLoaded() const;
+
+		std::vector<const Bus*> SortedBuses() const;
+
+		std::vector<const Stop*> SortedStops() const;
+
+		//stops as they are given and edges of whole route
+		IdsRange RouteStops(const Bus&) const;
+
+		IdsRange RouteEdges(const Bus&) const;
+
+		//returns place of new stop in route
+		size_t AppendRouteStop(const Bus*, uint32_t stop_id);
+
+		void BuildStopsBusesIndex();
+
+		//resolves every distinct segment of routes once, routes are stored as edges sequences
+		void BuildEdges();
+
+		RouteData CalculateRouteData(const Bus&) const;
+
+		size_t CountUniqueStops(const Bus&) const;
+
+		//drops all calculated routes data, buses index is built again
+		void ResetRoutesData();
+
+		static constexpr size_t BUSES_CHUNK = 256;
+		static constexpr size_t EDGES_BLOCK = 256;
 	};
 }
\ No newline at end of file